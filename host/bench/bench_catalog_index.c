@@ -0,0 +1,137 @@
+#include <pebble.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "include/core_status_bar.h"
+#include "include/stats_status_bar.h"
+
+//compares status_bar_item_catalog_find with the dense id table the catalog used to have (one pointer per possible id,
+//item_id_count of them), for several item counts and id spreads. prints one line per case, with the mean lookup cost
+//of each in host clock ticks (see mock_clock_ticks), and the bytes each takes besides the items themselves
+//(for the catalog: its id index, item table and bitsets, from the catalog heap).
+//
+//usage: bench_catalog_index [--rounds N]
+
+
+//-----------//
+// Constants //
+//-----------//
+
+#define BENCH_CATALOG_INDEX_ROUNDS_DEFAULT 200		//lookups of every id, per case
+
+
+//------------//
+// Data Types //
+//------------//
+
+typedef struct bench_id_spread_s {
+	const char *name;
+	uint32_t base;
+	uint32_t stride;
+} bench_id_spread_t;
+
+
+//-------------//
+// Static vars //
+//-------------//
+
+static const size_t s_bench_item_counts[] = { 16, 64, 256 };
+
+static const bench_id_spread_t s_bench_id_spreads[] = {
+	{ "dense", 0, 1 },
+	{ "strided", 0, 64 },
+	{ "resource_ids", 0x10000, 3 },		//ids derived from resource ids: high, and a few apart
+};
+
+
+//-------//
+// Cases //
+//-------//
+
+static uint32_t bench_time_catalog( uint32_t *ids, size_t item_count, int rounds ){
+	volatile uintptr_t sink = 0;
+	uint32_t start = mock_clock_ticks();
+	for( int round = 0; round < rounds; round++ ){
+		for( size_t i = 0; i < item_count; i++ ){
+			sink += (uintptr_t)status_bar_item_catalog_find( ids[i] );
+		}
+	}
+	return mock_clock_ticks() - start;
+}
+
+static uint32_t bench_time_dense_table( status_bar_item_t **dense_table, uint32_t *ids, size_t item_count, int rounds ){
+	volatile uintptr_t sink = 0;
+	uint32_t start = mock_clock_ticks();
+	for( int round = 0; round < rounds; round++ ){
+		for( size_t i = 0; i < item_count; i++ ){
+			sink += (uintptr_t)dense_table[ids[i]];
+		}
+	}
+	return mock_clock_ticks() - start;
+}
+
+//returns false if some lookup found the wrong item
+static bool bench_run_case( size_t item_count, const bench_id_spread_t *spread, int rounds ){
+	uint32_t *ids = malloc( item_count * sizeof(*ids) );
+	size_t id_count = spread->base + ( item_count - 1 ) * spread->stride + 1;
+	status_bar_item_t **dense_table = calloc( id_count, sizeof(*dense_table) );
+
+	status_bar_item_catalog_init( id_count );		//the id range, as apps pass it
+	for( size_t i = 0; i < item_count; i++ ){
+		ids[i] = spread->base + i * spread->stride;
+		status_bar_item_t *item = status_bar_item_create( GTextAlignmentLeft, STATUS_BAR_BORDER_DISTANCE_CLOSE, ids[i], 1, false );
+		status_bar_item_catalog_insert( item );
+		dense_table[ids[i]] = item;
+	}
+
+	bool is_correct = true;
+	for( size_t i = 0; i < item_count; i++ ){
+		is_correct &= ( status_bar_item_catalog_find( ids[i] ) == dense_table[ids[i]] );
+	}
+	is_correct &= ( NULL == status_bar_item_catalog_find( id_count ) );
+
+	size_t index_bytes =
+		status_bar_stats_get()->heaps[STATUS_BAR_STATS_HEAP_CATALOG].current_bytes - item_count * sizeof(status_bar_item_t);
+	uint32_t index_ticks = bench_time_catalog( ids, item_count, rounds );
+	uint32_t dense_ticks = bench_time_dense_table( dense_table, ids, item_count, rounds );
+	double lookup_count = (double)rounds * item_count;
+
+	printf(
+		"bench catalog_index items=%zu ids=%s index_ticks=%.2f dense_ticks=%.2f index_bytes=%zu dense_bytes=%zu\n",
+		item_count, spread->name, index_ticks / lookup_count, dense_ticks / lookup_count,
+		index_bytes, id_count * sizeof(*dense_table)
+	);
+
+	status_bar_item_catalog_deinit();
+	free( dense_table );
+	free( ids );
+	return is_correct;
+}
+
+
+int main( int argc, char *argv[] ){
+	int rounds = BENCH_CATALOG_INDEX_ROUNDS_DEFAULT;
+	for( int i = 1; i < argc; i++ ){
+		if( 0 == strcmp( argv[i], "--rounds" ) && i + 1 < argc ){
+			rounds = atoi( argv[++i] );
+		} else {
+			fprintf( stderr, "usage: %s [--rounds N]\n", argv[0] );
+			return 2;
+		}
+	}
+	if( rounds < 1 ){
+		rounds = 1;
+	}
+
+	mock_set_log_enabled( false );
+
+	for( size_t c = 0; c < ARRAY_LENGTH( s_bench_item_counts ); c++ ){
+		for( size_t s = 0; s < ARRAY_LENGTH( s_bench_id_spreads ); s++ ){
+			if( !bench_run_case( s_bench_item_counts[c], &( s_bench_id_spreads[s] ), rounds ) ){
+				printf( "items=%zu ids=%s: a lookup found the wrong item\n", s_bench_item_counts[c], s_bench_id_spreads[s].name );
+				return 1;
+			}
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,189 @@
+#include <pebble.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "include/core_status_bar.h"
+#include "include/window_status_bar.h"
+#include "include/stats_status_bar.h"
+
+//times the status bar's events on the host: layout builds, renders and the tick/battery/connection handlers.
+//each event runs --rounds times (default BENCH_EVENTS_ROUNDS_DEFAULT) on a window showing BENCH_EVENTS_ITEM_COUNT items,
+//and prints one line with its fastest and mean cost in host clock ticks (see mock_clock_ticks),
+//plus the library's mallocs and frees per event. handlers are timed alone: whatever they invalidated is
+//rendered afterwards, outside the timing.
+//
+//usage: bench_events [--rounds N]
+
+
+//-----------//
+// Constants //
+//-----------//
+
+#define BENCH_EVENTS_ROUNDS_DEFAULT 1000
+#define BENCH_EVENTS_ITEM_COUNT 16
+
+
+//------------//
+// Data Types //
+//------------//
+
+typedef enum {
+	BENCH_EVENT_BUILD_LAYOUT,
+	BENCH_EVENT_RENDER,
+	BENCH_EVENT_TICK,
+	BENCH_EVENT_BATTERY,
+	BENCH_EVENT_CONNECTION,
+
+	BENCH_EVENT_COUNT
+} bench_event_t;
+
+typedef struct bench_result_s {
+	uint32_t min_ticks;
+	uint64_t total_ticks;
+	uint32_t alloc_count;
+	uint32_t free_count;
+} bench_result_t;
+
+
+//-------------//
+// Static vars //
+//-------------//
+
+static const char *s_bench_event_names[BENCH_EVENT_COUNT] = {
+	[BENCH_EVENT_BUILD_LAYOUT] = "build_layout",
+	[BENCH_EVENT_RENDER] = "render",
+	[BENCH_EVENT_TICK] = "tick",
+	[BENCH_EVENT_BATTERY] = "battery",
+	[BENCH_EVENT_CONNECTION] = "connection"
+};
+
+static bench_result_t s_bench_results[BENCH_EVENT_COUNT];
+
+
+//--------//
+// Events //
+//--------//
+
+static void bench_event_run( status_bar_window_t *status_bar_window, bench_event_t event, int round ){
+	struct tm tick_time = { .tm_hour = 10, .tm_min = round % 60 };
+
+	switch( event ){
+		case BENCH_EVENT_BUILD_LAYOUT:
+			status_bar_window_build_layout( status_bar_window );
+			break;
+		case BENCH_EVENT_RENDER:
+			mock_window_render( status_bar_window_get_window( status_bar_window ) );
+			break;
+		case BENCH_EVENT_TICK:
+			mock_tick( &tick_time, MINUTE_UNIT );
+			break;
+		case BENCH_EVENT_BATTERY:
+			mock_set_battery_state( (BatteryChargeState){ .charge_percent = 0 == round % 2 ? 70 : 80 } );
+			break;
+		case BENCH_EVENT_CONNECTION:
+			mock_set_connected( 0 != round % 2 );
+			break;
+		default:
+			break;
+	}
+}
+
+static void bench_event_measure( status_bar_window_t *status_bar_window, bench_event_t event, int round ){
+	Window *window = status_bar_window_get_window( status_bar_window );
+	if( BENCH_EVENT_BUILD_LAYOUT == event ){		//otherwise there's nothing to build
+		status_bar_window_mark_layout_dirty( status_bar_window );
+	} else if( BENCH_EVENT_RENDER == event ){
+		layer_mark_dirty( status_bar_window_get_status_bar_layer( status_bar_window ) );
+	}
+
+	const status_bar_stats_heap_usage_t *heap_usage = &( status_bar_stats_get()->heap_total );
+	uint32_t alloc_count = heap_usage->alloc_count;
+	uint32_t free_count = heap_usage->free_count;
+
+	uint32_t start = mock_clock_ticks();
+	bench_event_run( status_bar_window, event, round );
+	uint32_t elapsed = mock_clock_ticks() - start;
+
+	bench_result_t *result = &( s_bench_results[event] );
+	if( 0 == round || elapsed < result->min_ticks ){
+		result->min_ticks = elapsed;
+	}
+	result->total_ticks += elapsed;
+	result->alloc_count += heap_usage->alloc_count - alloc_count;
+	result->free_count += heap_usage->free_count - free_count;
+
+	//catch up with whatever the event invalidated
+	if( mock_window_is_dirty( window ) ){
+		mock_window_render( window );
+	}
+}
+
+
+int main( int argc, char *argv[] ){
+	int rounds = BENCH_EVENTS_ROUNDS_DEFAULT;
+	for( int i = 1; i < argc; i++ ){
+		if( 0 == strcmp( argv[i], "--rounds" ) && i + 1 < argc ){
+			rounds = atoi( argv[++i] );
+		} else {
+			fprintf( stderr, "usage: %s [--rounds N]\n", argv[0] );
+			return 2;
+		}
+	}
+	if( rounds < 1 ){
+		rounds = 1;
+	}
+
+	mock_set_log_enabled( false );
+	mock_set_connected( true );
+	mock_set_battery_state( (BatteryChargeState){ .charge_percent = 80 } );
+
+	//a catalog mixing alignments, distances, texts and phone-only items
+	status_bar_item_catalog_init( BENCH_EVENTS_ITEM_COUNT );
+	for( int i = 0; i < BENCH_EVENTS_ITEM_COUNT; i++ ){
+		status_bar_item_t *item = status_bar_item_create(
+			(GTextAlignment)( i % 3 ), (status_bar_border_distance_t)( i % 2 ), i, 100 + i, 0 == i % 4
+		);
+		status_bar_item_catalog_insert( item );
+		status_bar_item_load_icon( item );
+		if( 0 == i % 3 ){
+			status_bar_item_set_text( item, "12" );
+		}
+	}
+
+	status_bar_window_t *status_bar_window = status_bar_window_create( false );
+	Window *window = status_bar_window_get_window( status_bar_window );
+	mock_window_push( window );
+	mock_window_render( window );
+
+	for( int event = 0; event < BENCH_EVENT_COUNT; event++ ){
+		for( int round = 0; round < rounds; round++ ){
+			bench_event_measure( status_bar_window, event, round );
+		}
+	}
+
+	for( int event = 0; event < BENCH_EVENT_COUNT; event++ ){
+		bench_result_t *result = &( s_bench_results[event] );
+		printf(
+			"bench event=%s rounds=%d min_ticks=%lu mean_ticks=%lu allocs=%.2f frees=%.2f\n",
+			s_bench_event_names[event],
+			rounds,
+			(unsigned long)result->min_ticks,
+			(unsigned long)( result->total_ticks / rounds ),
+			(double)result->alloc_count / rounds,
+			(double)result->free_count / rounds
+		);
+	}
+
+	mock_window_pop( window );		//also destroys it
+	mock_run_timers();
+	status_bar_item_catalog_deinit();
+
+	//anything left is a leak
+	int32_t leaked_bitmaps = mock_get_live_bitmap_count();
+	uint32_t leaked_bytes = status_bar_stats_get()->heap_total.current_bytes;
+	if( 0 != leaked_bitmaps || 0 != leaked_bytes ){
+		printf( "leaked %ld bitmaps and %lu bytes\n", (long)leaked_bitmaps, (unsigned long)leaked_bytes );
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,138 @@
+#include <pebble.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "include/core_status_bar.h"
+#include "include/window_status_bar.h"
+#include "include/stats_status_bar.h"
+
+//sweeps catalog sizes, distance distributions, text lengths and alignment mixes through layout building and display list
+//compiling. each case gets its own catalog and a fresh window, and prints one "status bar bench" line with its fastest
+//round of each, in host clock ticks (see mock_clock_ticks), and the library's mallocs over all rounds.
+//tools/check_layout_benchmark.py compares those lines with host/bench/layout_benchmark_baseline.json.
+//
+//usage: bench_layout [--rounds N]
+
+
+//-----------//
+// Constants //
+//-----------//
+
+#define BENCH_LAYOUT_ROUNDS_DEFAULT 16		//layout builds timed per case
+
+
+//-------------//
+// Static vars //
+//-------------//
+
+static const uint16_t s_bench_item_counts[] = { 1, 10, 50, 100, 250, 500 };
+
+static const char *s_bench_distance_names[] = { "close", "spread" };
+static const char *s_bench_text_names[] = { "none", "short", "long" };
+static char *s_bench_texts[] = { NULL, "12", "Long item text" };
+static const char *s_bench_alignment_names[] = { "left", "mixed" };
+static const GTextAlignment s_bench_mixed_alignments[] = { GTextAlignmentLeft, GTextAlignmentCenter, GTextAlignmentRight };
+
+
+//-------//
+// Cases //
+//-------//
+
+//fills a catalog with the case's items, then times building and compiling the layout of a window showing them
+static void bench_run_case( uint16_t item_count, size_t distance_distribution, size_t text_length, size_t alignment_mix, int rounds ){
+	status_bar_item_catalog_init( item_count );
+	status_bar_item_catalog_begin_update();
+	for( uint16_t i = 0; i < item_count; i++ ){
+		status_bar_item_t *item = status_bar_item_create(
+			( alignment_mix == 0 ) ? GTextAlignmentLeft : s_bench_mixed_alignments[i % 3],
+			( distance_distribution == 0 ) ? STATUS_BAR_BORDER_DISTANCE_CLOSE : STATUS_BAR_BORDER_DISTANCE_CLOSE + i % 3,
+			i, 100 + i, false
+		);
+		status_bar_item_catalog_insert( item );
+		status_bar_item_set_text( item, s_bench_texts[text_length] );
+		status_bar_item_load_icon( item );
+	}
+	status_bar_item_catalog_commit_update();
+
+	status_bar_window_t *status_bar_window = status_bar_window_create( false );
+	Window *window = status_bar_window_get_window( status_bar_window );
+	mock_window_push( window );
+	mock_window_render( window );
+
+	uint32_t alloc_count = status_bar_stats_get()->heap_total.alloc_count;
+	uint32_t build_ticks = UINT32_MAX;
+	uint32_t compile_ticks = UINT32_MAX;
+	for( int round = 0; round < rounds; round++ ){
+		status_bar_window_mark_layout_dirty( status_bar_window );
+
+		uint32_t start = mock_clock_ticks();
+		status_bar_window_build_layout( status_bar_window );
+		uint32_t built = mock_clock_ticks();
+		status_bar_window_layout_compile( status_bar_window_get_layout( status_bar_window ) );
+		uint32_t compiled = mock_clock_ticks();
+
+		if( built - start < build_ticks ){
+			build_ticks = built - start;
+		}
+		if( compiled - built < compile_ticks ){
+			compile_ticks = compiled - built;
+		}
+	}
+	long allocs = status_bar_stats_get()->heap_total.alloc_count - alloc_count;
+
+	printf(
+		"status bar bench items=%u distances=%s texts=%s alignments=%s rounds=%d build_ticks=%lu compile_ticks=%lu allocs=%ld\n",
+		item_count,
+		s_bench_distance_names[distance_distribution],
+		s_bench_text_names[text_length],
+		s_bench_alignment_names[alignment_mix],
+		rounds,
+		(unsigned long)build_ticks,
+		(unsigned long)compile_ticks,
+		allocs
+	);
+
+	mock_window_pop( window );		//also destroys it
+	mock_run_timers();
+	status_bar_item_catalog_deinit();
+}
+
+
+int main( int argc, char *argv[] ){
+	int rounds = BENCH_LAYOUT_ROUNDS_DEFAULT;
+	for( int i = 1; i < argc; i++ ){
+		if( 0 == strcmp( argv[i], "--rounds" ) && i + 1 < argc ){
+			rounds = atoi( argv[++i] );
+		} else {
+			fprintf( stderr, "usage: %s [--rounds N]\n", argv[0] );
+			return 2;
+		}
+	}
+	if( rounds < 1 ){
+		rounds = 1;
+	}
+
+	mock_set_log_enabled( false );
+	mock_set_connected( true );
+	mock_set_24h_style( true );
+	mock_set_battery_state( (BatteryChargeState){ .charge_percent = 80 } );
+
+	for( size_t c = 0; c < ARRAY_LENGTH( s_bench_item_counts ); c++ ){
+		for( size_t d = 0; d < ARRAY_LENGTH( s_bench_distance_names ); d++ ){
+			for( size_t t = 0; t < ARRAY_LENGTH( s_bench_text_names ); t++ ){
+				for( size_t a = 0; a < ARRAY_LENGTH( s_bench_alignment_names ); a++ ){
+					bench_run_case( s_bench_item_counts[c], d, t, a, rounds );
+				}
+			}
+		}
+	}
+
+	//anything left is a leak
+	int32_t leaked_bitmaps = mock_get_live_bitmap_count();
+	uint32_t leaked_bytes = status_bar_stats_get()->heap_total.current_bytes;
+	if( 0 != leaked_bitmaps || 0 != leaked_bytes ){
+		printf( "leaked %ld bitmaps and %lu bytes\n", (long)leaked_bitmaps, (unsigned long)leaked_bytes );
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,125 @@
+#include <pebble.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "include/window_status_bar.h"
+
+//times filling a layout with hundreds of items and putting them in render order (status_bar_window_layout_add_item
+//for each, then status_bar_window_layout_finish), for several item counts and orders of border distances.
+//prints one line per case, with its fastest round in host clock ticks (see mock_clock_ticks) and per item:
+//insertion is constant time, so ticks per item should stay flat as the item count grows, whatever the order.
+//
+//usage: bench_layout_insert [--rounds N]
+
+
+//-----------//
+// Constants //
+//-----------//
+
+#define BENCH_LAYOUT_INSERT_ROUNDS_DEFAULT 200
+
+
+//------------//
+// Data Types //
+//------------//
+
+//orders in which items' border distances arrive
+typedef enum {
+	BENCH_ORDER_ASCENDING,		//each item goes after all the others
+	BENCH_ORDER_DESCENDING,		//each item goes before all the others
+	BENCH_ORDER_MIXED,
+
+	BENCH_ORDER_COUNT
+} bench_order_t;
+
+
+//-------------//
+// Static vars //
+//-------------//
+
+static const size_t s_bench_item_counts[] = { 100, 250, 500, 1000 };
+
+static const char *s_bench_order_names[BENCH_ORDER_COUNT] = {
+	[BENCH_ORDER_ASCENDING] = "ascending",
+	[BENCH_ORDER_DESCENDING] = "descending",
+	[BENCH_ORDER_MIXED] = "mixed"
+};
+
+
+//-------//
+// Cases //
+//-------//
+
+static status_bar_border_distance_t bench_get_distance( bench_order_t order, size_t i, size_t item_count ){
+	switch( order ){
+		case BENCH_ORDER_ASCENDING:
+			return (status_bar_border_distance_t)( i * STATUS_BAR_BORDER_DISTANCE_COUNT / item_count );
+		case BENCH_ORDER_DESCENDING:
+			return (status_bar_border_distance_t)( STATUS_BAR_BORDER_DISTANCE_COUNT - 1 - i * STATUS_BAR_BORDER_DISTANCE_COUNT / item_count );
+		default:
+			return (status_bar_border_distance_t)( ( i * 7 ) % STATUS_BAR_BORDER_DISTANCE_COUNT );
+	}
+}
+
+//returns the fastest round, or 0 if some item was rejected
+static uint32_t bench_run_case( status_bar_window_layout_t *layout, size_t item_count, bench_order_t order, int rounds ){
+	//items take no room, so none is rejected for not fitting
+	status_bar_window_layout_item_parts_t parts = { .distance_offset = -STATUS_BAR_ITEM_DISTANCE };
+	uint32_t min_ticks = UINT32_MAX;
+
+	for( int round = 0; round < rounds; round++ ){
+		status_bar_window_layout_reset( layout );
+
+		uint32_t start = mock_clock_ticks();
+		for( size_t i = 0; i < item_count; i++ ){
+			if( NULL == status_bar_window_layout_add_item(
+				layout, (GTextAlignment)( i % 3 ), bench_get_distance( order, i, item_count ), parts, NULL
+			) ){
+				return 0;
+			}
+		}
+		status_bar_window_layout_finish( layout );
+		uint32_t elapsed = mock_clock_ticks() - start;
+
+		if( elapsed < min_ticks ){
+			min_ticks = elapsed;
+		}
+	}
+	return min_ticks;
+}
+
+
+int main( int argc, char *argv[] ){
+	int rounds = BENCH_LAYOUT_INSERT_ROUNDS_DEFAULT;
+	for( int i = 1; i < argc; i++ ){
+		if( 0 == strcmp( argv[i], "--rounds" ) && i + 1 < argc ){
+			rounds = atoi( argv[++i] );
+		} else {
+			fprintf( stderr, "usage: %s [--rounds N]\n", argv[0] );
+			return 2;
+		}
+	}
+	if( rounds < 1 ){
+		rounds = 1;
+	}
+
+	for( size_t c = 0; c < ARRAY_LENGTH( s_bench_item_counts ); c++ ){
+		size_t item_count = s_bench_item_counts[c];
+		status_bar_window_layout_t *layout = status_bar_window_layout_create( item_count );
+
+		for( int order = 0; order < BENCH_ORDER_COUNT; order++ ){
+			uint32_t min_ticks = bench_run_case( layout, item_count, order, rounds );
+			if( 0 == min_ticks ){
+				printf( "items=%zu order=%s: an item was rejected\n", item_count, s_bench_order_names[order] );
+				return 1;
+			}
+			printf(
+				"bench layout_insert items=%zu order=%s min_ticks=%lu ticks_per_item=%.1f\n",
+				item_count, s_bench_order_names[order], (unsigned long)min_ticks, (double)min_ticks / item_count
+			);
+		}
+
+		status_bar_window_layout_destroy( layout );
+	}
+	return 0;
+}
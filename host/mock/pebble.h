@@ -0,0 +1,297 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+
+//stand-in for the Pebble SDK's pebble.h, with just the parts of the API the package uses, so it can be built and
+//tested on the host (see pebble_mock.h for the controls tests and benchmarks get on top of it)
+
+
+//-----------//
+// Platform  //
+//-----------//
+
+#define PBL_SDK_3
+#define PBL_IF_COLOR_ELSE( if_true, if_false ) ( if_false )
+#define ARRAY_LENGTH( array ) ( sizeof( array ) / sizeof( (array)[0] ) )
+
+
+//----------//
+// Geometry //
+//----------//
+
+typedef struct GPoint {
+	int16_t x;
+	int16_t y;
+} GPoint;
+
+typedef struct GSize {
+	int16_t w;
+	int16_t h;
+} GSize;
+
+typedef struct GRect {
+	GPoint origin;
+	GSize size;
+} GRect;
+
+#define GPoint( x, y ) ( (GPoint){ (x), (y) } )
+#define GSize( w, h ) ( (GSize){ (w), (h) } )
+#define GRect( x, y, w, h ) ( (GRect){ { (x), (y) }, { (w), (h) } } )
+#define GPointZero GPoint( 0, 0 )
+#define GRectZero GRect( 0, 0, 0, 0 )
+
+
+//----------//
+// Graphics //
+//----------//
+
+typedef union GColor8 {
+	uint8_t argb;
+} GColor8;
+typedef GColor8 GColor;
+
+#define GColorBlack ( (GColor8){ 0xC0 } )
+#define GColorWhite ( (GColor8){ 0xFF } )
+#define GColorClear ( (GColor8){ 0x00 } )
+
+typedef enum {
+	GTextAlignmentLeft,
+	GTextAlignmentCenter,
+	GTextAlignmentRight
+} GTextAlignment;
+
+typedef enum {
+	GTextOverflowModeWordWrap,
+	GTextOverflowModeTrailingEllipsis,
+	GTextOverflowModeFill
+} GTextOverflowMode;
+
+typedef enum {
+	GCompOpAssign,
+	GCompOpAssignInverted,
+	GCompOpOr,
+	GCompOpAnd,
+	GCompOpClear,
+	GCompOpSet
+} GCompOp;
+
+typedef enum {
+	GCornerNone = 0
+} GCornerMask;
+
+typedef enum {
+	GBitmapFormat1Bit,
+	GBitmapFormat8Bit,
+	GBitmapFormat1BitPalette,
+	GBitmapFormat2BitPalette,
+	GBitmapFormat4BitPalette,
+	GBitmapFormat8BitCircular
+} GBitmapFormat;
+
+typedef struct GBitmap GBitmap;
+typedef struct FontInfo *GFont;
+typedef struct GContext GContext;
+typedef struct GTextAttributes GTextAttributes;
+
+typedef struct GBitmapDataRowInfo {
+	uint8_t *data;
+	int16_t min_x;
+	int16_t max_x;
+} GBitmapDataRowInfo;
+
+//bitmaps
+GBitmap *gbitmap_create_with_resource( uint32_t resource_id );
+GBitmap *gbitmap_create_as_sub_bitmap( const GBitmap *base_bitmap, GRect sub_rect );
+GBitmap *gbitmap_create_blank( GSize size, GBitmapFormat format );
+void gbitmap_destroy( GBitmap *bitmap );
+GRect gbitmap_get_bounds( const GBitmap *bitmap );
+uint8_t *gbitmap_get_data( const GBitmap *bitmap );
+uint16_t gbitmap_get_bytes_per_row( const GBitmap *bitmap );
+GBitmapFormat gbitmap_get_format( const GBitmap *bitmap );
+GBitmapDataRowInfo gbitmap_get_data_row_info( const GBitmap *bitmap, uint16_t y );
+
+//fonts and text
+#define FONT_KEY_GOTHIC_14 "RESOURCE_ID_GOTHIC_14"
+#define FONT_KEY_GOTHIC_18_BOLD "RESOURCE_ID_GOTHIC_18_BOLD"
+
+GFont fonts_get_system_font( const char *font_key );
+GSize graphics_text_layout_get_content_size(
+	const char *text, GFont font, GRect box, GTextOverflowMode overflow_mode, GTextAlignment alignment
+);
+
+//drawing
+void graphics_context_set_compositing_mode( GContext *ctx, GCompOp mode );
+void graphics_context_set_fill_color( GContext *ctx, GColor color );
+void graphics_context_set_text_color( GContext *ctx, GColor color );
+void graphics_draw_bitmap_in_rect( GContext *ctx, const GBitmap *bitmap, GRect rect );
+void graphics_fill_rect( GContext *ctx, GRect rect, uint16_t corner_radius, GCornerMask corner_mask );
+void graphics_draw_text(
+	GContext *ctx, const char *text, GFont font, GRect box,
+	GTextOverflowMode overflow_mode, GTextAlignment alignment, GTextAttributes *text_attributes
+);
+GBitmap *graphics_capture_frame_buffer( GContext *ctx );
+bool graphics_release_frame_buffer( GContext *ctx, GBitmap *buffer );
+
+
+//--------------------//
+// Layers and Windows //
+//--------------------//
+
+typedef struct Layer Layer;
+typedef struct Window Window;
+
+typedef void (*LayerUpdateProc)( Layer *layer, GContext *ctx );
+
+Layer *layer_create( GRect frame );
+Layer *layer_create_with_data( GRect frame, size_t data_size );
+void layer_destroy( Layer *layer );
+void *layer_get_data( const Layer *layer );
+void layer_set_update_proc( Layer *layer, LayerUpdateProc update_proc );
+void layer_add_child( Layer *parent, Layer *child );
+void layer_mark_dirty( Layer *layer );
+void layer_set_frame( Layer *layer, GRect frame );
+GRect layer_get_frame( const Layer *layer );
+void layer_set_bounds( Layer *layer, GRect bounds );
+GRect layer_get_bounds( const Layer *layer );
+void layer_set_hidden( Layer *layer, bool hidden );
+GPoint layer_convert_point_to_screen( const Layer *layer, GPoint point );
+
+typedef void (*WindowHandler)( Window *window );
+typedef struct WindowHandlers {
+	WindowHandler load;
+	WindowHandler appear;
+	WindowHandler disappear;
+	WindowHandler unload;
+} WindowHandlers;
+
+Window *window_create(void);
+void window_destroy( Window *window );
+void window_set_user_data( Window *window, void *data );
+void *window_get_user_data( const Window *window );
+void window_set_background_color( Window *window, GColor background_color );
+void window_set_window_handlers( Window *window, WindowHandlers handlers );
+Layer *window_get_root_layer( const Window *window );
+
+
+//----------//
+// Services //
+//----------//
+
+//tick timer
+typedef enum {
+	SECOND_UNIT = 1 << 0,
+	MINUTE_UNIT = 1 << 1,
+	HOUR_UNIT = 1 << 2,
+	DAY_UNIT = 1 << 3,
+	MONTH_UNIT = 1 << 4,
+	YEAR_UNIT = 1 << 5
+} TimeUnits;
+
+typedef void (*TickHandler)( struct tm *tick_time, TimeUnits units_changed );
+void tick_timer_service_subscribe( TimeUnits tick_units, TickHandler handler );
+void tick_timer_service_unsubscribe(void);
+
+//battery
+typedef struct BatteryChargeState {
+	uint8_t charge_percent;
+	bool is_charging;
+	bool is_plugged;
+} BatteryChargeState;
+
+typedef void (*BatteryStateHandler)( BatteryChargeState charge );
+void battery_state_service_subscribe( BatteryStateHandler handler );
+void battery_state_service_unsubscribe(void);
+BatteryChargeState battery_state_service_peek(void);
+
+//connection
+typedef void (*ConnectionHandler)( bool connected );
+typedef struct ConnectionHandlers {
+	ConnectionHandler pebble_app_connection_handler;
+	ConnectionHandler pebblekit_connection_handler;
+} ConnectionHandlers;
+
+void connection_service_subscribe( ConnectionHandlers handlers );
+void connection_service_unsubscribe(void);
+bool connection_service_peek_pebble_app_connection(void);
+
+//wall time
+bool clock_is_24h_style(void);
+uint16_t time_ms( time_t *tloc, uint16_t *out_ms );
+
+
+//--------//
+// Timers //
+//--------//
+
+typedef struct AppTimer AppTimer;
+typedef void (*AppTimerCallback)( void *data );
+
+AppTimer *app_timer_register( uint32_t timeout_ms, AppTimerCallback callback, void *callback_data );
+bool app_timer_reschedule( AppTimer *timer, uint32_t new_timeout_ms );
+void app_timer_cancel( AppTimer *timer );
+
+
+//---------//
+// Logging //
+//---------//
+
+typedef enum {
+	APP_LOG_LEVEL_ERROR = 1,
+	APP_LOG_LEVEL_WARNING = 50,
+	APP_LOG_LEVEL_INFO = 100,
+	APP_LOG_LEVEL_DEBUG = 200,
+	APP_LOG_LEVEL_DEBUG_VERBOSE = 255
+} AppLogLevel;
+
+void app_log( uint8_t log_level, const char *src_filename, int src_line_number, const char *fmt, ... )
+	__attribute__(( format( printf, 4, 5 ) ));
+#define APP_LOG( level, fmt, ... ) app_log( level, __FILE__, __LINE__, fmt, ##__VA_ARGS__ )
+
+
+//------------//
+// AppMessage //
+//------------//
+
+typedef enum {
+	TUPLE_BYTE_ARRAY = 0,
+	TUPLE_CSTRING = 1,
+	TUPLE_UINT = 2,
+	TUPLE_INT = 3
+} TupleType;
+
+typedef struct __attribute__(( packed )) Tuple {
+	uint32_t key;
+	TupleType type:8;
+	uint16_t length;
+	union {
+		uint8_t data[0];
+		char cstring[0];
+		uint8_t uint8;
+		uint16_t uint16;
+		uint32_t uint32;
+		int8_t int8;
+		int16_t int16;
+		int32_t int32;
+	} value[];
+} Tuple;
+
+typedef struct DictionaryIterator DictionaryIterator;
+Tuple *dict_find( const DictionaryIterator *iter, const uint32_t key );
+
+
+//-----------//
+// Resources //
+//-----------//
+
+//generated from package.json by the SDK (icons of the app's own items are any other id, see pebble_mock.h)
+#define RESOURCE_ID_ICON_STATUS_BAR_ATLAS 1
+
+#define MESSAGE_KEY_STATUS_BAR_PHONE_BATTERY 10000
+
+
+#include "pebble_mock.h"
@@ -0,0 +1,718 @@
+#define _POSIX_C_SOURCE 200809L
+#include <pebble.h>
+#include <stdarg.h>
+#if defined( __x86_64__ ) || defined( __i386__ )
+	#include <x86intrin.h>
+#endif
+
+
+//------------//
+// Data Types //
+//------------//
+
+struct GBitmap {
+	GRect bounds;
+	GBitmapFormat format;
+	uint16_t bytes_per_row;
+	uint8_t *data;
+	bool owns_data;					//sub-bitmaps share their base bitmap's data
+};
+
+struct FontInfo {
+	int16_t advance;
+	int16_t height;
+};
+
+struct GContext {
+	GPoint offset;					//screen position of the bounds of the layer being drawn
+	GBitmap frame_buffer;
+};
+
+struct Layer {
+	GRect frame;
+	GRect bounds;
+	bool is_hidden;
+	LayerUpdateProc update_proc;
+	void *data;
+
+	Layer *parent;
+	Layer *first_child;
+	Layer *next_sibling;
+	Window *window;					//only set on root layers
+};
+
+struct Window {
+	Layer *root_layer;
+	WindowHandlers handlers;
+	void *user_data;
+	bool is_loaded;
+	bool is_dirty;
+};
+
+struct AppTimer {
+	uint64_t due_ms;
+	AppTimerCallback callback;
+	void *data;
+	AppTimer *next;
+};
+
+struct DictionaryIterator {
+	Tuple *tuple;
+};
+
+
+//-------------//
+// Static vars //
+//-------------//
+
+static mock_counters_t s_mock_counters;
+static int32_t s_mock_live_bitmaps = 0;
+static bool s_mock_resource_load_fails = false;
+
+static struct FontInfo s_mock_font_gothic_14 = { MOCK_FONT_GOTHIC_14_ADVANCE, MOCK_FONT_GOTHIC_14_HEIGHT };
+static struct FontInfo s_mock_font_gothic_18_bold = { MOCK_FONT_GOTHIC_18_BOLD_ADVANCE, MOCK_FONT_GOTHIC_18_BOLD_HEIGHT };
+
+static uint8_t s_mock_frame_buffer_data[MOCK_SCREEN_WIDTH * MOCK_SCREEN_HEIGHT];
+static GContext s_mock_context = {
+	.frame_buffer = {
+		.bounds = { { 0, 0 }, { MOCK_SCREEN_WIDTH, MOCK_SCREEN_HEIGHT } },
+		.format = GBitmapFormat8Bit,
+		.bytes_per_row = MOCK_SCREEN_WIDTH,
+		.data = s_mock_frame_buffer_data
+	}
+};
+
+static TickHandler s_mock_tick_handler = NULL;
+static TimeUnits s_mock_tick_units = 0;
+static BatteryStateHandler s_mock_battery_handler = NULL;
+static BatteryChargeState s_mock_battery_state = { .charge_percent = 80 };
+static ConnectionHandlers s_mock_connection_handlers;
+static bool s_mock_is_connected = true;
+static bool s_mock_is_24h_style = true;
+
+static uint64_t s_mock_time_ms = MOCK_TIME_START_MS;
+static AppTimer *s_mock_timers = NULL;			//sorted by due time
+
+static union {
+	Tuple tuple;
+	uint8_t bytes[sizeof(Tuple) + sizeof(uint32_t)];
+} s_mock_tuple;
+static struct DictionaryIterator s_mock_dict = { &s_mock_tuple.tuple };
+
+static bool s_mock_is_log_enabled = true;
+
+
+//----------//
+// Counters //
+//----------//
+
+const mock_counters_t *mock_get_counters(void){
+	return &s_mock_counters;
+}
+
+void mock_reset_counters(void){
+	memset( &s_mock_counters, 0, sizeof(s_mock_counters) );
+}
+
+int32_t mock_get_live_bitmap_count(void){
+	return s_mock_live_bitmaps;
+}
+
+//folds a drawn rect, in screen coordinates, into the geometry hash
+static void mock_hash_rect( GContext *ctx, GRect rect ){
+	uint64_t hash =
+		(uint64_t)( rect.origin.x + ctx->offset.x ) * 1000003 +
+		(uint64_t)( rect.origin.y + ctx->offset.y ) * 1009 +
+		(uint64_t)rect.size.w * 31 +
+		(uint64_t)rect.size.h;
+	hash *= 2654435761u;
+	s_mock_counters.geometry_hash += hash ^ ( hash >> 13 );
+}
+
+
+//---------//
+// Bitmaps //
+//---------//
+
+static GBitmap *mock_bitmap_create( GSize size, GBitmapFormat format ){
+	GBitmap *bitmap = calloc( 1, sizeof(*bitmap) );
+	bitmap->bounds = GRect( 0, 0, size.w, size.h );
+	bitmap->format = format;
+	bitmap->bytes_per_row = ( GBitmapFormat1Bit == format ) ? ( ( size.w + 31 ) / 32 ) * 4 : size.w;
+	bitmap->data = calloc( 1, bitmap->bytes_per_row * size.h + 1 );
+	bitmap->owns_data = true;
+
+	s_mock_live_bitmaps++;
+	return bitmap;
+}
+
+void mock_set_resource_load_fails( bool fails ){
+	s_mock_resource_load_fails = fails;
+}
+
+GBitmap *gbitmap_create_with_resource( uint32_t resource_id ){
+	if( s_mock_resource_load_fails ){
+		return NULL;
+	}
+
+	return mock_bitmap_create(
+		( RESOURCE_ID_ICON_STATUS_BAR_ATLAS == resource_id ) ?
+			GSize( MOCK_ATLAS_WIDTH, MOCK_ATLAS_HEIGHT ) : GSize( MOCK_ICON_WIDTH, MOCK_ICON_HEIGHT ),
+		GBitmapFormat1Bit
+	);
+}
+
+GBitmap *gbitmap_create_as_sub_bitmap( const GBitmap *base_bitmap, GRect sub_rect ){
+	GBitmap *bitmap = calloc( 1, sizeof(*bitmap) );
+	bitmap->bounds = sub_rect;				//as on the watch, bounds keep the position within the base bitmap
+	bitmap->format = base_bitmap->format;
+	bitmap->bytes_per_row = base_bitmap->bytes_per_row;
+	bitmap->data = base_bitmap->data;
+	bitmap->owns_data = false;
+
+	s_mock_live_bitmaps++;
+	return bitmap;
+}
+
+GBitmap *gbitmap_create_blank( GSize size, GBitmapFormat format ){
+	return mock_bitmap_create( size, format );
+}
+
+void gbitmap_destroy( GBitmap *bitmap ){
+	if( NULL == bitmap ){
+		return;
+	}
+
+	if( bitmap->owns_data ){
+		free( bitmap->data );
+	}
+	free( bitmap );
+	s_mock_live_bitmaps--;
+}
+
+GRect gbitmap_get_bounds( const GBitmap *bitmap ){
+	return bitmap->bounds;
+}
+
+uint8_t *gbitmap_get_data( const GBitmap *bitmap ){
+	return bitmap->data;
+}
+
+uint16_t gbitmap_get_bytes_per_row( const GBitmap *bitmap ){
+	return bitmap->bytes_per_row;
+}
+
+GBitmapFormat gbitmap_get_format( const GBitmap *bitmap ){
+	return bitmap->format;
+}
+
+GBitmapDataRowInfo gbitmap_get_data_row_info( const GBitmap *bitmap, uint16_t y ){
+	return (GBitmapDataRowInfo){
+		.data = bitmap->data + y * bitmap->bytes_per_row,
+		.min_x = 0,
+		.max_x = bitmap->bounds.size.w - 1
+	};
+}
+
+
+//----------------//
+// Fonts and Text //
+//----------------//
+
+GFont fonts_get_system_font( const char *font_key ){
+	return ( 0 == strcmp( font_key, FONT_KEY_GOTHIC_18_BOLD ) ) ? &s_mock_font_gothic_18_bold : &s_mock_font_gothic_14;
+}
+
+GSize graphics_text_layout_get_content_size(
+	const char *text, GFont font, GRect box, GTextOverflowMode overflow_mode, GTextAlignment alignment
+){
+	(void)overflow_mode;
+	(void)alignment;
+	s_mock_counters.text_measures++;
+
+	int32_t width = (int32_t)strlen( text ) * font->advance;
+	return GSize( ( width < box.size.w ) ? width : box.size.w, font->height );
+}
+
+
+//---------//
+// Drawing //
+//---------//
+
+void graphics_context_set_compositing_mode( GContext *ctx, GCompOp mode ){
+	(void)ctx;
+	(void)mode;
+	s_mock_counters.compositing_mode_sets++;
+}
+
+void graphics_context_set_fill_color( GContext *ctx, GColor color ){
+	(void)ctx;
+	(void)color;
+}
+
+void graphics_context_set_text_color( GContext *ctx, GColor color ){
+	(void)ctx;
+	(void)color;
+}
+
+void graphics_draw_bitmap_in_rect( GContext *ctx, const GBitmap *bitmap, GRect rect ){
+	(void)bitmap;
+	s_mock_counters.bitmap_draws++;
+	mock_hash_rect( ctx, rect );
+}
+
+void graphics_fill_rect( GContext *ctx, GRect rect, uint16_t corner_radius, GCornerMask corner_mask ){
+	(void)corner_radius;
+	(void)corner_mask;
+	s_mock_counters.rect_fills++;
+	mock_hash_rect( ctx, rect );
+	s_mock_counters.last_fill_rect = GRect( rect.origin.x + ctx->offset.x, rect.origin.y + ctx->offset.y, rect.size.w, rect.size.h );
+}
+
+void graphics_draw_text(
+	GContext *ctx, const char *text, GFont font, GRect box,
+	GTextOverflowMode overflow_mode, GTextAlignment alignment, GTextAttributes *text_attributes
+){
+	(void)text;
+	(void)font;
+	(void)overflow_mode;
+	(void)alignment;
+	(void)text_attributes;
+	s_mock_counters.text_draws++;
+	mock_hash_rect( ctx, box );
+}
+
+GBitmap *graphics_capture_frame_buffer( GContext *ctx ){
+	return &( ctx->frame_buffer );
+}
+
+bool graphics_release_frame_buffer( GContext *ctx, GBitmap *buffer ){
+	return buffer == &( ctx->frame_buffer );
+}
+
+
+//--------//
+// Layers //
+//--------//
+
+Layer *layer_create( GRect frame ){
+	Layer *layer = calloc( 1, sizeof(*layer) );
+	layer->frame = frame;
+	layer->bounds = GRect( 0, 0, frame.size.w, frame.size.h );
+	return layer;
+}
+
+Layer *layer_create_with_data( GRect frame, size_t data_size ){
+	Layer *layer = layer_create( frame );
+	layer->data = calloc( 1, data_size );
+	return layer;
+}
+
+void layer_destroy( Layer *layer ){
+	if( NULL == layer ){
+		return;
+	}
+
+	//unlink from parent, and orphan children (as the watch does)
+	if( NULL != layer->parent ){
+		Layer **link = &( layer->parent->first_child );
+		while( *link != layer ){
+			link = &( (*link)->next_sibling );
+		}
+		*link = layer->next_sibling;
+	}
+	for( Layer *child = layer->first_child; NULL != child; child = child->next_sibling ){
+		child->parent = NULL;
+	}
+
+	free( layer->data );
+	free( layer );
+}
+
+void *layer_get_data( const Layer *layer ){
+	return layer->data;
+}
+
+void layer_set_update_proc( Layer *layer, LayerUpdateProc update_proc ){
+	layer->update_proc = update_proc;
+}
+
+void layer_add_child( Layer *parent, Layer *child ){
+	Layer **link = &( parent->first_child );
+	while( NULL != *link ){
+		link = &( (*link)->next_sibling );
+	}
+	*link = child;
+	child->parent = parent;
+	child->next_sibling = NULL;
+}
+
+void layer_mark_dirty( Layer *layer ){
+	s_mock_counters.layer_dirty_marks++;
+
+	while( NULL != layer->parent ){
+		layer = layer->parent;
+	}
+	if( NULL != layer->window ){
+		layer->window->is_dirty = true;
+	}
+}
+
+void layer_set_frame( Layer *layer, GRect frame ){
+	if( layer->bounds.size.w == layer->frame.size.w && layer->bounds.size.h == layer->frame.size.h ){
+		layer->bounds.size = frame.size;
+	}
+	layer->frame = frame;
+}
+
+GRect layer_get_frame( const Layer *layer ){
+	return layer->frame;
+}
+
+void layer_set_bounds( Layer *layer, GRect bounds ){
+	layer->bounds = bounds;
+}
+
+GRect layer_get_bounds( const Layer *layer ){
+	return layer->bounds;
+}
+
+void layer_set_hidden( Layer *layer, bool hidden ){
+	layer->is_hidden = hidden;
+}
+
+GPoint layer_convert_point_to_screen( const Layer *layer, GPoint point ){
+	for( ; NULL != layer; layer = layer->parent ){
+		point.x += layer->frame.origin.x + layer->bounds.origin.x;
+		point.y += layer->frame.origin.y + layer->bounds.origin.y;
+	}
+	return point;
+}
+
+static void mock_layer_render( Layer *layer, GPoint parent_offset ){
+	if( layer->is_hidden ){
+		return;
+	}
+
+	GPoint offset = GPoint(
+		parent_offset.x + layer->frame.origin.x + layer->bounds.origin.x,
+		parent_offset.y + layer->frame.origin.y + layer->bounds.origin.y
+	);
+	if( NULL != layer->update_proc ){
+		s_mock_context.offset = offset;
+		layer->update_proc( layer, &s_mock_context );
+	}
+
+	for( Layer *child = layer->first_child; NULL != child; child = child->next_sibling ){
+		mock_layer_render( child, offset );
+	}
+}
+
+
+//---------//
+// Windows //
+//---------//
+
+Window *window_create(void){
+	Window *window = calloc( 1, sizeof(*window) );
+	window->root_layer = layer_create( GRect( 0, 0, MOCK_SCREEN_WIDTH, MOCK_SCREEN_HEIGHT ) );
+	window->root_layer->window = window;
+	return window;
+}
+
+void window_destroy( Window *window ){
+	if( NULL == window ){
+		return;
+	}
+
+	layer_destroy( window->root_layer );
+	free( window );
+}
+
+void window_set_user_data( Window *window, void *data ){
+	window->user_data = data;
+}
+
+void *window_get_user_data( const Window *window ){
+	return window->user_data;
+}
+
+void window_set_background_color( Window *window, GColor background_color ){
+	(void)window;
+	(void)background_color;
+}
+
+void window_set_window_handlers( Window *window, WindowHandlers handlers ){
+	window->handlers = handlers;
+}
+
+Layer *window_get_root_layer( const Window *window ){
+	return window->root_layer;
+}
+
+void mock_window_push( Window *window ){
+	if( !window->is_loaded && NULL != window->handlers.load ){
+		window->handlers.load( window );
+	}
+	window->is_loaded = true;
+	window->is_dirty = true;
+
+	if( NULL != window->handlers.appear ){
+		window->handlers.appear( window );
+	}
+}
+
+void mock_window_pop( Window *window ){
+	if( NULL != window->handlers.disappear ){
+		window->handlers.disappear( window );
+	}
+
+	window->is_loaded = false;
+	if( NULL != window->handlers.unload ){
+		window->handlers.unload( window );
+	}
+}
+
+void mock_window_render( Window *window ){
+	window->is_dirty = false;
+	mock_layer_render( window->root_layer, GPointZero );
+}
+
+bool mock_window_is_dirty( Window *window ){
+	return window->is_dirty;
+}
+
+
+//----------//
+// Services //
+//----------//
+
+//tick timer
+void tick_timer_service_subscribe( TimeUnits tick_units, TickHandler handler ){
+	s_mock_tick_units = tick_units;
+	s_mock_tick_handler = handler;
+}
+
+void tick_timer_service_unsubscribe(void){
+	s_mock_tick_units = 0;
+	s_mock_tick_handler = NULL;
+}
+
+void mock_tick( struct tm *tick_time, TimeUnits units_changed ){
+	if( NULL != s_mock_tick_handler ){
+		s_mock_tick_handler( tick_time, units_changed );
+	}
+}
+
+TimeUnits mock_get_tick_units(void){
+	return s_mock_tick_units;
+}
+
+//battery
+void battery_state_service_subscribe( BatteryStateHandler handler ){
+	s_mock_battery_handler = handler;
+}
+
+void battery_state_service_unsubscribe(void){
+	s_mock_battery_handler = NULL;
+}
+
+BatteryChargeState battery_state_service_peek(void){
+	return s_mock_battery_state;
+}
+
+void mock_set_battery_state( BatteryChargeState state ){
+	s_mock_battery_state = state;
+	if( NULL != s_mock_battery_handler ){
+		s_mock_battery_handler( state );
+	}
+}
+
+//connection
+void connection_service_subscribe( ConnectionHandlers handlers ){
+	s_mock_connection_handlers = handlers;
+}
+
+void connection_service_unsubscribe(void){
+	memset( &s_mock_connection_handlers, 0, sizeof(s_mock_connection_handlers) );
+}
+
+bool connection_service_peek_pebble_app_connection(void){
+	return s_mock_is_connected;
+}
+
+void mock_set_connected( bool connected ){
+	s_mock_is_connected = connected;
+	if( NULL != s_mock_connection_handlers.pebble_app_connection_handler ){
+		s_mock_connection_handlers.pebble_app_connection_handler( connected );
+	}
+}
+
+//wall time
+bool clock_is_24h_style(void){
+	return s_mock_is_24h_style;
+}
+
+void mock_set_24h_style( bool is_24h_style ){
+	s_mock_is_24h_style = is_24h_style;
+}
+
+uint16_t time_ms( time_t *tloc, uint16_t *out_ms ){
+	uint16_t ms = s_mock_time_ms % 1000;
+	if( NULL != tloc ){
+		*tloc = (time_t)( s_mock_time_ms / 1000 );
+	}
+	if( NULL != out_ms ){
+		*out_ms = ms;
+	}
+	return ms;
+}
+
+
+//--------//
+// Timers //
+//--------//
+
+static void mock_timer_link( AppTimer *timer ){
+	AppTimer **link = &s_mock_timers;
+	while( NULL != *link && (*link)->due_ms <= timer->due_ms ){		//timers due at the same time fire in order
+		link = &( (*link)->next );
+	}
+	timer->next = *link;
+	*link = timer;
+}
+
+static bool mock_timer_unlink( AppTimer *timer ){
+	for( AppTimer **link = &s_mock_timers; NULL != *link; link = &( (*link)->next ) ){
+		if( *link == timer ){
+			*link = timer->next;
+			return true;
+		}
+	}
+	return false;
+}
+
+AppTimer *app_timer_register( uint32_t timeout_ms, AppTimerCallback callback, void *callback_data ){
+	AppTimer *timer = calloc( 1, sizeof(*timer) );
+	timer->due_ms = s_mock_time_ms + timeout_ms;
+	timer->callback = callback;
+	timer->data = callback_data;
+
+	mock_timer_link( timer );
+	return timer;
+}
+
+bool app_timer_reschedule( AppTimer *timer, uint32_t new_timeout_ms ){
+	if( !mock_timer_unlink( timer ) ){		//already fired, or cancelled
+		return false;
+	}
+
+	timer->due_ms = s_mock_time_ms + new_timeout_ms;
+	mock_timer_link( timer );
+	return true;
+}
+
+void app_timer_cancel( AppTimer *timer ){
+	if( mock_timer_unlink( timer ) ){
+		free( timer );
+	}
+}
+
+void mock_advance_time( uint32_t ms ){
+	uint64_t target_ms = s_mock_time_ms + ms;
+
+	while( NULL != s_mock_timers && s_mock_timers->due_ms <= target_ms ){
+		AppTimer *timer = s_mock_timers;
+		s_mock_timers = timer->next;
+		if( timer->due_ms > s_mock_time_ms ){
+			s_mock_time_ms = timer->due_ms;
+		}
+
+		timer->callback( timer->data );
+		free( timer );
+	}
+
+	s_mock_time_ms = target_ms;
+}
+
+void mock_run_timers(void){
+	while( NULL != s_mock_timers ){
+		mock_advance_time( ( s_mock_timers->due_ms > s_mock_time_ms ) ? s_mock_timers->due_ms - s_mock_time_ms : 0 );
+	}
+}
+
+size_t mock_get_pending_timer_count(void){
+	size_t count = 0;
+	for( AppTimer *timer = s_mock_timers; NULL != timer; timer = timer->next ){
+		count++;
+	}
+	return count;
+}
+
+
+//------------//
+// AppMessage //
+//------------//
+
+DictionaryIterator *mock_dict_uint( uint32_t key, uint32_t value, uint16_t length ){
+	s_mock_tuple.tuple.key = key;
+	s_mock_tuple.tuple.type = TUPLE_UINT;
+	s_mock_tuple.tuple.length = length;
+
+	switch( length ){
+		case sizeof(uint8_t):
+			s_mock_tuple.tuple.value->uint8 = (uint8_t)value;
+			break;
+		case sizeof(uint16_t):
+			s_mock_tuple.tuple.value->uint16 = (uint16_t)value;
+			break;
+		default:
+			s_mock_tuple.tuple.value->uint32 = value;
+			break;
+	}
+
+	return &s_mock_dict;
+}
+
+Tuple *dict_find( const DictionaryIterator *iter, const uint32_t key ){
+	return ( NULL != iter->tuple && key == iter->tuple->key ) ? iter->tuple : NULL;
+}
+
+
+//---------//
+// Logging //
+//---------//
+
+void mock_set_log_enabled( bool enabled ){
+	s_mock_is_log_enabled = enabled;
+}
+
+void app_log( uint8_t log_level, const char *src_filename, int src_line_number, const char *fmt, ... ){
+	(void)log_level;
+	(void)src_filename;
+	(void)src_line_number;
+	if( !s_mock_is_log_enabled ){
+		return;
+	}
+
+	va_list args;
+	va_start( args, fmt );
+	vprintf( fmt, args );
+	va_end( args );
+	putchar( '\n' );
+}
+
+
+//------------//
+// Host Clock //
+//------------//
+
+uint32_t mock_clock_ticks(void){
+#if defined( __x86_64__ ) || defined( __i386__ )
+	return (uint32_t)__rdtsc();
+#else
+	struct timespec now;
+	clock_gettime( CLOCK_MONOTONIC, &now );
+	return (uint32_t)( (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec );
+#endif
+}
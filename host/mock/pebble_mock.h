@@ -0,0 +1,123 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+//host-only controls on top of the mock SDK in pebble.h (the real SDK has none of these), for tests and benchmarks
+
+
+//-----------//
+// Constants //
+//-----------//
+
+#define MOCK_SCREEN_WIDTH 144
+#define MOCK_SCREEN_HEIGHT 168
+
+// Resources (the atlas has the size of src/resources/images/ICON_STATUS_BAR_ATLAS, any other id is an app icon)
+#define MOCK_ATLAS_WIDTH 32
+#define MOCK_ATLAS_HEIGHT 16
+#define MOCK_ICON_WIDTH 11
+#define MOCK_ICON_HEIGHT 11				//1-bit icons have 4 bytes per row, so an icon is 44 bytes
+
+// Fonts (every glyph of a font has the same advance)
+#define MOCK_FONT_GOTHIC_14_ADVANCE 5
+#define MOCK_FONT_GOTHIC_14_HEIGHT 10
+#define MOCK_FONT_GOTHIC_18_BOLD_ADVANCE 7
+#define MOCK_FONT_GOTHIC_18_BOLD_HEIGHT 14
+
+// Time (time_ms follows a fake clock, which only moves with mock_advance_time)
+#define MOCK_TIME_START_MS 1000000
+
+
+//------------//
+// Data Types //
+//------------//
+
+//calls counted since the last mock_reset_counters
+typedef struct mock_counters_s {
+	uint32_t text_measures;
+	uint32_t text_draws;
+	uint32_t bitmap_draws;
+	uint32_t rect_fills;
+	uint32_t compositing_mode_sets;
+	uint32_t layer_dirty_marks;
+	uint64_t geometry_hash;			//of every rect drawn, to compare what two builds draw
+	GRect last_fill_rect;			//in screen coordinates
+} mock_counters_t;
+
+
+//----------//
+// Counters //
+//----------//
+
+const mock_counters_t *mock_get_counters(void);
+void mock_reset_counters(void);
+int32_t mock_get_live_bitmap_count(void);		//bitmaps created and not destroyed yet
+
+
+//-----------//
+// Resources //
+//-----------//
+
+void mock_set_resource_load_fails( bool fails );		//gbitmap_create_with_resource returns NULL while set
+
+
+//---------//
+// Windows //
+//---------//
+
+//runs the window handlers as the window stack would (pop also unloads, like the last reference going away)
+void mock_window_push( Window *window );
+void mock_window_pop( Window *window );
+
+//runs the update procs of every visible layer, parents first, as a frame on the watch would (the whole window is
+//redrawn, whichever layer was marked dirty)
+void mock_window_render( Window *window );
+bool mock_window_is_dirty( Window *window );		//some layer of the window was marked dirty since the last render
+
+
+//----------//
+// Services //
+//----------//
+
+//each calls the subscribed handler, if there's one
+void mock_tick( struct tm *tick_time, TimeUnits units_changed );
+void mock_set_battery_state( BatteryChargeState state );
+void mock_set_connected( bool connected );
+
+TimeUnits mock_get_tick_units(void);		//0 if nothing is subscribed
+void mock_set_24h_style( bool is_24h_style );
+
+
+//-----------------//
+// Time and Timers //
+//-----------------//
+
+//advances the fake clock, firing the timers that come due on the way (in order)
+void mock_advance_time( uint32_t ms );
+void mock_run_timers(void);				//advances the fake clock until no timer is pending
+size_t mock_get_pending_timer_count(void);
+
+
+//------------//
+// AppMessage //
+//------------//
+
+//a dictionary holding a single unsigned integer tuple, of length 1, 2 or 4 bytes (valid until the next call)
+DictionaryIterator *mock_dict_uint( uint32_t key, uint32_t value, uint16_t length );
+
+
+//---------//
+// Logging //
+//---------//
+
+void mock_set_log_enabled( bool enabled );		//APP_LOG prints to stdout while enabled (the default)
+
+
+//------------//
+// Host Clock //
+//------------//
+
+//real time, for benchmarks and the profiling hooks: TSC cycles on x86, nanoseconds elsewhere
+//(differences are only meaningful between calls less than a second or so apart)
+uint32_t mock_clock_ticks(void);
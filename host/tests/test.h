@@ -0,0 +1,49 @@
+#pragma once
+#include <pebble.h>
+#include <stdio.h>
+
+//minimal test harness for the host target: each test file runs its tests from main with TEST_RUN,
+//and returns TEST_RESULT() (failed checks are printed, and make the executable exit with 1)
+
+
+//-------------//
+// Static vars //
+//-------------//
+
+static int s_test_failures = 0;
+static const char *s_test_name = "";
+
+
+//--------//
+// Checks //
+//--------//
+
+#define TEST_RUN( test ) ( s_test_name = #test, test() )
+#define TEST_CHECK( condition ) test_check( (condition), #condition, __FILE__, __LINE__ )
+#define TEST_CHECK_EQUAL( actual, expected ) \
+	test_check_equal( (long long)(actual), (long long)(expected), #actual, #expected, __FILE__, __LINE__ )
+#define TEST_RESULT() test_result()
+
+static inline void test_check( bool is_passed, const char *condition, const char *file, int line ){
+	if( !is_passed ){
+		printf( "%s:%d: %s: check failed: %s\n", file, line, s_test_name, condition );
+		s_test_failures++;
+	}
+}
+
+static inline void test_check_equal(
+	long long actual, long long expected, const char *actual_text, const char *expected_text, const char *file, int line
+){
+	if( actual != expected ){
+		printf( "%s:%d: %s: %s is %lld, expected %s (%lld)\n", file, line, s_test_name, actual_text, actual, expected_text, expected );
+		s_test_failures++;
+	}
+}
+
+static inline int test_result(void){
+	if( s_test_failures > 0 ){
+		printf( "%d checks failed\n", s_test_failures );
+		return 1;
+	}
+	return 0;
+}
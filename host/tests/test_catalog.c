@@ -0,0 +1,190 @@
+#include <pebble.h>
+#include "include/core_status_bar.h"
+#include "include/stats_status_bar.h"
+#include "test.h"
+
+
+//----------//
+// Fixtures //
+//----------//
+
+//a static catalog, with ids out of priority order, and one id left unused
+enum { TEST_STATIC_ITEM_MAIL, TEST_STATIC_ITEM_ALARM, TEST_STATIC_ITEM_UNUSED, TEST_STATIC_ITEM_ID_COUNT };
+
+#define TEST_STATIC_ITEMS( ITEM )																\
+	ITEM( TEST_STATIC_ITEM_ALARM, GTextAlignmentLeft, STATUS_BAR_BORDER_DISTANCE_CLOSE, 2, false )	\
+	ITEM( TEST_STATIC_ITEM_MAIL, GTextAlignmentRight, STATUS_BAR_BORDER_DISTANCE_FAR, 3, true )
+
+STATUS_BAR_ITEM_CATALOG_DEFINE( TEST_STATIC_ITEMS, TEST_STATIC_ITEM_ID_COUNT )
+
+#define TEST_ITEM_COUNT 300
+
+//the state the shown bits are checked against
+static bool s_is_connected;
+static uint8_t s_hidden_app_flags;
+
+//walks the whole catalog, and checks the shown items are exactly the ones that should be, in priority order
+static void test_check_shown(void){
+	status_bar_item_t *shown = status_bar_item_catalog_get_first_shown();
+	for( status_bar_item_t *item = status_bar_item_catalog_get_first(); NULL != item; item = status_bar_item_get_next( item ) ){
+		bool is_shown = status_bar_item_get_visible( item ) &&
+			( s_is_connected || !status_bar_item_get_requires_phone_connection( item ) ) &&
+			0 == ( item->app_flags & s_hidden_app_flags );
+		if( is_shown ){
+			TEST_CHECK( shown == item );
+			if( NULL == shown ){
+				return;
+			}
+			shown = status_bar_item_catalog_get_next_shown( shown );
+		}
+	}
+	TEST_CHECK( NULL == shown );
+}
+
+static void test_set_connected( bool connected ){
+	s_is_connected = connected;
+	status_bar_item_catalog_set_is_connected_to_phone( connected );
+}
+
+static void test_set_hidden_app_flags( uint8_t app_flags ){
+	s_hidden_app_flags = app_flags;
+	status_bar_item_catalog_set_hidden_app_flags( app_flags );
+}
+
+
+//-------//
+// Tests //
+//-------//
+
+static void test_sparse_ids(void){
+	status_bar_item_catalog_init( 0 );		//the id index grows as needed
+
+	//ids far apart, and colliding in a small index
+	for( uint32_t i = 0; i < TEST_ITEM_COUNT; i++ ){
+		status_bar_item_catalog_insert( status_bar_item_create( GTextAlignmentLeft, STATUS_BAR_BORDER_DISTANCE_CLOSE, i * 4096, 1, false ) );
+	}
+	TEST_CHECK_EQUAL( status_bar_item_catalog_get_count(), TEST_ITEM_COUNT );
+	for( uint32_t i = 0; i < TEST_ITEM_COUNT; i++ ){
+		status_bar_item_t *item = status_bar_item_catalog_find( i * 4096 );
+		TEST_CHECK( NULL != item && item->id == i * 4096 );
+	}
+	TEST_CHECK( NULL == status_bar_item_catalog_find( 4095 ) );
+	TEST_CHECK( NULL == status_bar_item_catalog_find( TEST_ITEM_COUNT * 4096 ) );
+
+	//priority is insertion order, whatever the ids
+	uint32_t expected_id = 0;
+	for( status_bar_item_t *item = status_bar_item_catalog_get_first(); NULL != item; item = status_bar_item_get_next( item ) ){
+		TEST_CHECK_EQUAL( item->id, expected_id );
+		expected_id += 4096;
+	}
+
+	status_bar_item_catalog_deinit();
+	TEST_CHECK_EQUAL( status_bar_stats_get()->heap_total.current_bytes, 0 );
+}
+
+static void test_init_hint_capped(void){
+	const status_bar_stats_heap_usage_t *catalog_heap = &( status_bar_stats_get()->heaps[STATUS_BAR_STATS_HEAP_CATALOG] );
+	status_bar_item_catalog_init( STATUS_BAR_ITEM_CATALOG_INIT_MAX_ITEMS );
+	uint32_t capped_bytes = catalog_heap->current_bytes;
+	status_bar_item_catalog_deinit();
+
+	//a sparse id range presizes no more than the cap
+	status_bar_item_catalog_init( TEST_ITEM_COUNT * 4096 );
+	TEST_CHECK_EQUAL( catalog_heap->current_bytes, capped_bytes );
+	status_bar_item_catalog_deinit();
+	TEST_CHECK_EQUAL( status_bar_stats_get()->heap_total.current_bytes, 0 );
+}
+
+static void test_shown_bits(void){
+	mock_set_connected( false );
+	s_is_connected = false;
+	s_hidden_app_flags = 0;
+	status_bar_item_catalog_init( 0 );
+
+	//icons loaded before and after insertion, some items needing the phone, and a mix of app flags
+	status_bar_item_t *items[TEST_ITEM_COUNT];
+	for( int i = 0; i < TEST_ITEM_COUNT; i++ ){
+		items[i] = status_bar_item_create( GTextAlignmentLeft, STATUS_BAR_BORDER_DISTANCE_CLOSE, i, 1, 0 == i % 5 );
+		if( 0 == i % 7 ){
+			status_bar_item_load_icon( items[i] );
+		}
+		status_bar_item_catalog_insert( items[i] );
+		if( 0 == i % 3 ){
+			status_bar_item_load_icon( items[i] );
+		}
+		status_bar_item_set_app_flags( items[i], i % 4 );
+	}
+	test_check_shown();
+
+	test_set_connected( true );
+	test_check_shown();
+	test_set_hidden_app_flags( 1 );
+	test_check_shown();
+	test_set_hidden_app_flags( 3 );
+	test_check_shown();
+
+	for( int i = 0; i < TEST_ITEM_COUNT; i += 2 ){
+		status_bar_item_unload_icon( items[i] );
+	}
+	test_check_shown();
+	for( int i = 1; i < TEST_ITEM_COUNT; i += 4 ){
+		status_bar_item_set_app_flags( items[i], 0 );
+	}
+	test_check_shown();
+
+	test_set_connected( false );
+	test_check_shown();
+	test_set_hidden_app_flags( 0 );
+	test_check_shown();
+
+	status_bar_item_catalog_deinit();
+	TEST_CHECK_EQUAL( mock_get_live_bitmap_count(), 0 );
+	TEST_CHECK_EQUAL( status_bar_stats_get()->heap_total.current_bytes, 0 );
+}
+
+static void test_static_catalog(void){
+	uint32_t alloc_count = status_bar_stats_get()->heap_total.alloc_count;
+
+	//twice, as apps re-init a static catalog after a deinit
+	for( int i = 0; i < 2; i++ ){
+		mock_set_connected( true );
+		s_is_connected = true;
+		s_hidden_app_flags = 0;
+		STATUS_BAR_ITEM_CATALOG_INIT_STATIC();
+
+		TEST_CHECK_EQUAL( status_bar_item_catalog_get_count(), 2 );
+		TEST_CHECK_EQUAL( status_bar_item_catalog_get_first()->id, TEST_STATIC_ITEM_ALARM );
+		TEST_CHECK_EQUAL( status_bar_item_get_next( status_bar_item_catalog_get_first() )->id, TEST_STATIC_ITEM_MAIL );
+		TEST_CHECK( NULL == status_bar_item_catalog_find( TEST_STATIC_ITEM_UNUSED ) );
+		TEST_CHECK( NULL == status_bar_item_catalog_find( TEST_STATIC_ITEM_ID_COUNT ) );
+
+		status_bar_item_load_icon( status_bar_item_catalog_find( TEST_STATIC_ITEM_ALARM ) );
+		status_bar_item_load_icon( status_bar_item_catalog_find( TEST_STATIC_ITEM_MAIL ) );
+		test_check_shown();
+		test_set_connected( false );
+		test_check_shown();
+
+		//static catalogs take no more items
+		status_bar_item_catalog_insert( status_bar_item_create( GTextAlignmentLeft, STATUS_BAR_BORDER_DISTANCE_CLOSE, 9, 1, false ) );
+		TEST_CHECK_EQUAL( status_bar_item_catalog_get_count(), 2 );
+
+		status_bar_item_catalog_deinit();
+	}
+
+	//nothing but the two icons and the rejected item was allocated, each round
+	TEST_CHECK_EQUAL( status_bar_stats_get()->heap_total.current_bytes, 0 );
+	TEST_CHECK_EQUAL( status_bar_stats_get()->heap_total.alloc_count - alloc_count, 2 * 3 );
+	TEST_CHECK_EQUAL( mock_get_live_bitmap_count(), 0 );
+}
+
+
+int main(void){
+	mock_set_log_enabled( false );
+
+	TEST_RUN( test_sparse_ids );
+	TEST_RUN( test_init_hint_capped );
+	TEST_RUN( test_shown_bits );
+	TEST_RUN( test_static_catalog );
+
+	return TEST_RESULT();
+}
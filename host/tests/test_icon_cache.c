@@ -0,0 +1,128 @@
+#include <pebble.h>
+#include "include/core_status_bar.h"
+#include "include/stats_status_bar.h"
+#include "test.h"
+
+
+//-----------//
+// Constants //
+//-----------//
+
+#define TEST_ICON_BYTES ( 4 * MOCK_ICON_HEIGHT )		//1-bit rows are padded to 4 bytes
+
+
+//----------//
+// Fixtures //
+//----------//
+
+static status_bar_item_t *test_item_create( uint32_t item_id ){
+	return status_bar_item_create( GTextAlignmentLeft, STATUS_BAR_BORDER_DISTANCE_CLOSE, item_id, 100 + item_id, false );
+}
+
+static void test_catalog_deinit(void){
+	status_bar_item_catalog_deinit();
+	TEST_CHECK_EQUAL( mock_get_live_bitmap_count(), 0 );
+	TEST_CHECK_EQUAL( status_bar_stats_get()->heap_total.current_bytes, 0 );
+}
+
+
+//-------//
+// Tests //
+//-------//
+
+static void test_insert_counts_icon_once(void){
+	status_bar_item_catalog_init( 4 );
+
+	//icon loaded before insertion
+	status_bar_item_t *item = test_item_create( 1 );
+	status_bar_item_load_icon( item );
+	TEST_CHECK_EQUAL( status_bar_item_catalog_get_icon_resident_bytes(), 0 );
+	status_bar_item_catalog_insert( item );
+	TEST_CHECK_EQUAL( status_bar_item_catalog_get_icon_resident_bytes(), TEST_ICON_BYTES );
+	status_bar_item_unload_icon( item );
+	TEST_CHECK_EQUAL( status_bar_item_catalog_get_icon_resident_bytes(), 0 );
+
+	//and after insertion
+	status_bar_item_load_icon( item );
+	TEST_CHECK_EQUAL( status_bar_item_catalog_get_icon_resident_bytes(), TEST_ICON_BYTES );
+	status_bar_item_unload_icon( item );
+	TEST_CHECK_EQUAL( status_bar_item_catalog_get_icon_resident_bytes(), 0 );
+
+	//items never inserted don't count
+	status_bar_item_t *outside_item = test_item_create( 2 );
+	status_bar_item_load_icon( outside_item );
+	TEST_CHECK_EQUAL( status_bar_item_catalog_get_icon_resident_bytes(), 0 );
+	status_bar_item_destroy( outside_item );
+	TEST_CHECK_EQUAL( status_bar_item_catalog_get_icon_resident_bytes(), 0 );
+
+	test_catalog_deinit();
+}
+
+static void test_shown_icons_are_never_evicted(void){
+	mock_set_connected( true );
+	status_bar_item_catalog_init( 4 );
+	status_bar_item_catalog_set_icon_budget( TEST_ICON_BYTES );
+
+	status_bar_item_t *items[3];
+	for( int i = 0; i < 3; i++ ){
+		items[i] = test_item_create( i );
+		status_bar_item_catalog_insert( items[i] );
+		status_bar_item_load_icon( items[i] );
+	}
+	TEST_CHECK_EQUAL( status_bar_item_catalog_get_icon_resident_bytes(), 3 * TEST_ICON_BYTES );
+	TEST_CHECK_EQUAL( status_bar_item_catalog_get_icon_eviction_count(), 0 );
+
+	//unloaded icons are evicted as soon as they're over budget
+	status_bar_item_unload_icon( items[0] );
+	status_bar_item_unload_icon( items[1] );
+	TEST_CHECK_EQUAL( status_bar_item_catalog_get_icon_resident_bytes(), TEST_ICON_BYTES );
+	TEST_CHECK_EQUAL( status_bar_item_catalog_get_icon_eviction_count(), 2 );
+
+	//over budget, with nothing left to evict
+	status_bar_item_load_icon( items[0] );
+	TEST_CHECK_EQUAL( status_bar_item_catalog_get_icon_resident_bytes(), 2 * TEST_ICON_BYTES );
+	TEST_CHECK_EQUAL( status_bar_item_catalog_get_icon_eviction_count(), 2 );
+	TEST_CHECK( NULL != items[0]->icon && NULL != items[2]->icon );
+
+	test_catalog_deinit();
+}
+
+static void test_batch_trims_once(void){
+	mock_set_connected( true );
+	status_bar_item_catalog_init( 4 );
+	status_bar_item_catalog_set_icon_budget( TEST_ICON_BYTES );
+
+	status_bar_item_t *items[3];
+	for( int i = 0; i < 3; i++ ){
+		items[i] = test_item_create( i );
+		status_bar_item_catalog_insert( items[i] );
+		status_bar_item_set_app_flags( items[i], 1 );
+		status_bar_item_load_icon( items[i] );
+	}
+
+	//hiding every item makes them all evictable, but nothing is evicted before the commit
+	status_bar_item_catalog_begin_update();
+	status_bar_item_catalog_set_hidden_app_flags( 1 );
+	status_bar_item_unload_icon( items[2] );
+	TEST_CHECK_EQUAL( status_bar_item_catalog_get_icon_resident_bytes(), 3 * TEST_ICON_BYTES );
+	TEST_CHECK_EQUAL( status_bar_item_catalog_get_icon_eviction_count(), 0 );
+	status_bar_item_catalog_commit_update();
+
+	//then least recently used first
+	TEST_CHECK_EQUAL( status_bar_item_catalog_get_icon_resident_bytes(), TEST_ICON_BYTES );
+	TEST_CHECK_EQUAL( status_bar_item_catalog_get_icon_eviction_count(), 2 );
+	TEST_CHECK( NULL == items[0]->icon && NULL == items[1]->icon && NULL != items[2]->icon );
+
+	test_catalog_deinit();
+}
+
+
+int main(void){
+	mock_set_log_enabled( false );
+
+	TEST_RUN( test_insert_counts_icon_once );
+	TEST_RUN( test_shown_icons_are_never_evicted );
+	TEST_RUN( test_batch_trims_once );
+
+	return TEST_RESULT();
+}
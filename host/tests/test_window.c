@@ -0,0 +1,383 @@
+#include <pebble.h>
+#include "include/core_status_bar.h"
+#include "include/window_status_bar.h"
+#include "include/stats_status_bar.h"
+#include "include/profile_status_bar.h"
+#include "test.h"
+
+
+//----------//
+// Fixtures //
+//----------//
+
+static status_bar_item_t *s_item_left;		//icon and text
+static status_bar_item_t *s_item_right;		//icon only, needs the phone
+
+//pushes a window showing a small catalog, and renders its first frame
+static status_bar_window_t *test_window_push(void){
+	mock_set_connected( true );
+	mock_set_24h_style( true );
+	mock_set_battery_state( (BatteryChargeState){ .charge_percent = 80 } );
+
+	status_bar_item_catalog_init( 8 );
+	s_item_left = status_bar_item_create( GTextAlignmentLeft, STATUS_BAR_BORDER_DISTANCE_FAR, 1, 100, false );
+	s_item_right = status_bar_item_create( GTextAlignmentRight, STATUS_BAR_BORDER_DISTANCE_CLOSE, 2, 101, true );
+	status_bar_item_catalog_insert( s_item_left );
+	status_bar_item_catalog_insert( s_item_right );
+	status_bar_item_load_icon( s_item_left );
+	status_bar_item_load_icon( s_item_right );
+	status_bar_item_set_text( s_item_left, "12" );
+
+	status_bar_window_t *status_bar_window = status_bar_window_create( false );
+	mock_window_push( status_bar_window_get_window( status_bar_window ) );
+	mock_window_render( status_bar_window_get_window( status_bar_window ) );
+	return status_bar_window;
+}
+
+//pops the window, and checks nothing it allocated was left behind
+static void test_window_pop( status_bar_window_t *status_bar_window ){
+	mock_window_pop( status_bar_window_get_window( status_bar_window ) );		//also destroys it
+	mock_run_timers();
+	status_bar_item_catalog_deinit();
+
+	TEST_CHECK_EQUAL( mock_get_pending_timer_count(), 0 );
+	TEST_CHECK_EQUAL( mock_get_live_bitmap_count(), 0 );
+	TEST_CHECK_EQUAL( status_bar_stats_get()->heap_total.current_bytes, 0 );
+}
+
+static void test_tick( int hour, int min, int sec, TimeUnits units_changed ){
+	struct tm tick_time = { .tm_hour = hour, .tm_min = min, .tm_sec = sec };
+	mock_tick( &tick_time, units_changed );
+}
+
+
+//-------//
+// Tests //
+//-------//
+
+static void test_push_builds_layout_once(void){
+	status_bar_window_t *status_bar_window = test_window_push();
+	Window *window = status_bar_window_get_window( status_bar_window );
+
+	TEST_CHECK_EQUAL( status_bar_window_get_rebuild_count( status_bar_window ), 1 );
+	TEST_CHECK_EQUAL( status_bar_window_get_redraw_count( status_bar_window ), 1 );
+	TEST_CHECK( !mock_window_is_dirty( window ) );
+
+	//a redraw with nothing changed doesn't rebuild
+	mock_reset_counters();
+	mock_window_render( window );
+	TEST_CHECK_EQUAL( status_bar_window_get_rebuild_count( status_bar_window ), 1 );
+	TEST_CHECK_EQUAL( mock_get_counters()->text_measures, 0 );
+	TEST_CHECK( mock_get_counters()->text_draws > 0 );
+
+	test_window_pop( status_bar_window );
+}
+
+static void test_tick_updates_clock_in_place(void){
+	status_bar_window_t *status_bar_window = test_window_push();
+	Window *window = status_bar_window_get_window( status_bar_window );
+	test_tick( 10, 5, 0, MINUTE_UNIT );
+	mock_window_render( window );
+	uint32_t rebuild_count = status_bar_window_get_rebuild_count( status_bar_window );
+
+	test_tick( 10, 6, 0, MINUTE_UNIT );
+	TEST_CHECK( mock_window_is_dirty( window ) );
+	mock_window_render( window );
+	TEST_CHECK_EQUAL( status_bar_window_get_rebuild_count( status_bar_window ), rebuild_count );
+
+	//same text, nothing to redraw
+	uint32_t suppressed = status_bar_stats_get()->counters[STATUS_BAR_STATS_COUNTER_SUPPRESSED_TICK];
+	test_tick( 10, 6, 0, MINUTE_UNIT );
+	TEST_CHECK( !mock_window_is_dirty( window ) );
+	TEST_CHECK_EQUAL( status_bar_stats_get()->counters[STATUS_BAR_STATS_COUNTER_SUPPRESSED_TICK], suppressed + 1 );
+
+	test_window_pop( status_bar_window );
+}
+
+static void test_battery_updates_in_place(void){
+	status_bar_window_t *status_bar_window = test_window_push();
+	Window *window = status_bar_window_get_window( status_bar_window );
+	uint32_t rebuild_count = status_bar_window_get_rebuild_count( status_bar_window );
+
+	mock_set_battery_state( (BatteryChargeState){ .charge_percent = 70 } );
+	TEST_CHECK( mock_window_is_dirty( window ) );
+	mock_window_render( window );
+	TEST_CHECK_EQUAL( status_bar_window_get_rebuild_count( status_bar_window ), rebuild_count );
+
+	uint32_t suppressed = status_bar_stats_get()->counters[STATUS_BAR_STATS_COUNTER_SUPPRESSED_BATTERY];
+	mock_set_battery_state( (BatteryChargeState){ .charge_percent = 70 } );
+	TEST_CHECK( !mock_window_is_dirty( window ) );
+	TEST_CHECK_EQUAL( status_bar_stats_get()->counters[STATUS_BAR_STATS_COUNTER_SUPPRESSED_BATTERY], suppressed + 1 );
+
+	test_window_pop( status_bar_window );
+}
+
+static void test_item_text_updates_in_place(void){
+	status_bar_window_t *status_bar_window = test_window_push();
+	Window *window = status_bar_window_get_window( status_bar_window );
+	uint32_t rebuild_count = status_bar_window_get_rebuild_count( status_bar_window );
+
+	status_bar_item_set_text( s_item_left, "123" );
+	TEST_CHECK( mock_window_is_dirty( window ) );
+	mock_window_render( window );
+	TEST_CHECK_EQUAL( status_bar_window_get_rebuild_count( status_bar_window ), rebuild_count );
+
+	//icon changes need a rebuild
+	status_bar_item_unload_icon( s_item_right );
+	mock_window_render( window );
+	TEST_CHECK_EQUAL( status_bar_window_get_rebuild_count( status_bar_window ), rebuild_count + 1 );
+
+	test_window_pop( status_bar_window );
+}
+
+static void test_batch_updates_once(void){
+	status_bar_window_t *status_bar_window = test_window_push();
+	Window *window = status_bar_window_get_window( status_bar_window );
+	uint32_t rebuild_count = status_bar_window_get_rebuild_count( status_bar_window );
+
+	status_bar_item_catalog_begin_update();
+	status_bar_item_set_text( s_item_left, "1" );
+	status_bar_item_unload_icon( s_item_right );
+	status_bar_item_catalog_begin_update();
+	status_bar_item_load_icon( s_item_right );
+	status_bar_item_catalog_commit_update();
+	TEST_CHECK( !mock_window_is_dirty( window ) );		//inner commit doesn't update the status bar
+
+	status_bar_item_catalog_commit_update();
+	TEST_CHECK( mock_window_is_dirty( window ) );
+	mock_window_render( window );
+	TEST_CHECK_EQUAL( status_bar_window_get_rebuild_count( status_bar_window ), rebuild_count + 1 );
+
+	test_window_pop( status_bar_window );
+}
+
+static void test_invalidation_interval_coalesces(void){
+	status_bar_window_t *status_bar_window = test_window_push();
+	Window *window = status_bar_window_get_window( status_bar_window );
+	status_bar_window_set_invalidation_interval( status_bar_window, 1000 );
+	mock_advance_time( 1000 );
+	uint32_t rebuild_count = status_bar_window_get_rebuild_count( status_bar_window );
+
+	//first change redraws right away, the others wait for the interval, and are redrawn together
+	for( int i = 0; i < 5; i++ ){
+		mock_set_connected( 0 == i % 2 );
+		if( mock_window_is_dirty( window ) ){
+			mock_window_render( window );
+		}
+	}
+	TEST_CHECK_EQUAL( status_bar_window_get_rebuild_count( status_bar_window ), rebuild_count + 1 );
+	TEST_CHECK_EQUAL( mock_get_pending_timer_count(), 1 );
+
+	mock_advance_time( 1000 );
+	TEST_CHECK( mock_window_is_dirty( window ) );
+	mock_window_render( window );
+	TEST_CHECK_EQUAL( status_bar_window_get_rebuild_count( status_bar_window ), rebuild_count + 2 );
+
+	test_window_pop( status_bar_window );
+}
+
+static void test_invalidation_interval_covers_in_place_updates(void){
+	status_bar_window_t *status_bar_window = test_window_push();
+	Window *window = status_bar_window_get_window( status_bar_window );
+	status_bar_window_set_invalidation_interval( status_bar_window, 1000 );
+	mock_advance_time( 1000 );
+	uint32_t rebuild_count = status_bar_window_get_rebuild_count( status_bar_window );
+
+	status_bar_item_set_text( s_item_left, "1" );
+	TEST_CHECK( mock_window_is_dirty( window ) );
+	mock_window_render( window );
+
+	//in-place updates wait for the interval too, and so do those made while a rebuild is pending
+	status_bar_item_set_text( s_item_left, "12" );
+	test_tick( 11, 0, 0, MINUTE_UNIT | HOUR_UNIT );
+	mock_set_connected( false );
+	status_bar_item_set_text( s_item_left, "123" );
+	mock_set_battery_state( (BatteryChargeState){ .charge_percent = 10 } );
+	TEST_CHECK( !mock_window_is_dirty( window ) );
+	TEST_CHECK_EQUAL( mock_get_pending_timer_count(), 1 );
+
+	mock_advance_time( 1000 );
+	TEST_CHECK( mock_window_is_dirty( window ) );
+	mock_window_render( window );
+	TEST_CHECK_EQUAL( status_bar_window_get_rebuild_count( status_bar_window ), rebuild_count + 1 );
+
+	test_window_pop( status_bar_window );
+}
+
+static void test_phone_battery(void){
+	status_bar_window_t *status_bar_window = test_window_push();
+	Window *window = status_bar_window_get_window( status_bar_window );
+	status_bar_window_set_phone_battery_interval( 0 );
+	uint32_t rebuild_count = status_bar_window_get_rebuild_count( status_bar_window );
+
+	//first update gives the phone icon a battery (a rebuild), the next ones update it in place
+	TEST_CHECK( status_bar_window_handle_app_message( mock_dict_uint( MESSAGE_KEY_STATUS_BAR_PHONE_BATTERY, 7, 1 ) ) );
+	mock_window_render( window );
+	TEST_CHECK_EQUAL( status_bar_window_get_rebuild_count( status_bar_window ), rebuild_count + 1 );
+
+	TEST_CHECK( status_bar_window_handle_app_message( mock_dict_uint( MESSAGE_KEY_STATUS_BAR_PHONE_BATTERY, 6, 4 ) ) );
+	TEST_CHECK( mock_window_is_dirty( window ) );
+	mock_window_render( window );
+	TEST_CHECK_EQUAL( status_bar_window_get_rebuild_count( status_bar_window ), rebuild_count + 1 );
+
+	//malformed updates are consumed but ignored, other messages aren't consumed
+	TEST_CHECK( status_bar_window_handle_app_message( mock_dict_uint( MESSAGE_KEY_STATUS_BAR_PHONE_BATTERY, 11, 1 ) ) );
+	TEST_CHECK( !mock_window_is_dirty( window ) );
+	TEST_CHECK( !status_bar_window_handle_app_message( mock_dict_uint( 5, 3, 1 ) ) );
+
+	//a burst within the interval is applied once, with its latest value
+	uint32_t coalesced = status_bar_stats_get()->counters[STATUS_BAR_STATS_COUNTER_COALESCED_PHONE_BATTERY];
+	status_bar_window_set_phone_battery_interval( 60000 );
+	for( uint32_t value = 1; value <= 5; value++ ){
+		status_bar_window_handle_app_message( mock_dict_uint( MESSAGE_KEY_STATUS_BAR_PHONE_BATTERY, value, 1 ) );
+	}
+	TEST_CHECK( !mock_window_is_dirty( window ) );
+	TEST_CHECK_EQUAL( status_bar_stats_get()->counters[STATUS_BAR_STATS_COUNTER_COALESCED_PHONE_BATTERY], coalesced + 4 );
+	mock_advance_time( 60000 );
+	TEST_CHECK( mock_window_is_dirty( window ) );
+	mock_window_render( window );
+
+	status_bar_window_set_phone_battery_interval( STATUS_BAR_PHONE_BATTERY_INTERVAL_MS_DEFAULT );
+	test_window_pop( status_bar_window );
+}
+
+static void test_seconds_clock(void){
+	status_bar_window_t *status_bar_window = test_window_push();
+	Window *window = status_bar_window_get_window( status_bar_window );
+	TEST_CHECK( !( mock_get_tick_units() & SECOND_UNIT ) );
+
+	status_bar_window_set_seconds_enabled( status_bar_window, true );
+	TEST_CHECK( mock_get_tick_units() & SECOND_UNIT );
+	mock_window_render( window );
+	uint32_t rebuild_count = status_bar_window_get_rebuild_count( status_bar_window );
+
+	//the clock has a fixed-width slot, so seconds never rebuild the layout
+	for( int sec = 57; sec < 60; sec++ ){
+		test_tick( 10, 6, sec, SECOND_UNIT );
+		mock_window_render( window );
+	}
+	test_tick( 9, 7, 0, SECOND_UNIT | MINUTE_UNIT | HOUR_UNIT );
+	mock_window_render( window );
+	TEST_CHECK_EQUAL( status_bar_window_get_rebuild_count( status_bar_window ), rebuild_count );
+
+	status_bar_window_set_seconds_enabled( status_bar_window, false );
+	TEST_CHECK( !( mock_get_tick_units() & SECOND_UNIT ) );
+
+	test_window_pop( status_bar_window );
+}
+
+static void test_render_profiles_once_per_zone(void){
+	status_bar_window_t *status_bar_window = test_window_push();
+	Window *window = status_bar_window_get_window( status_bar_window );
+
+	//the left item draws an icon and a text, yet both go into a single sample, as does the right item's icon
+	status_bar_profile_reset();
+	layer_mark_dirty( status_bar_window_get_status_bar_layer( status_bar_window ) );
+	mock_window_render( window );
+	TEST_CHECK_EQUAL( status_bar_profile_get_histogram( STATUS_BAR_PROFILE_POINT_RENDER_CATALOG_ITEM )->count, 2 );
+	TEST_CHECK_EQUAL( status_bar_profile_get_histogram( STATUS_BAR_PROFILE_POINT_RENDER_TIME )->count, 1 );
+	TEST_CHECK_EQUAL( status_bar_profile_get_histogram( STATUS_BAR_PROFILE_POINT_RENDER_BATTERY_ICON )->count, 1 );
+
+	test_window_pop( status_bar_window );
+}
+
+static void test_frame_cache(void){
+	status_bar_window_t *status_bar_window = test_window_push();
+	Window *window = status_bar_window_get_window( status_bar_window );
+	status_bar_window_set_frame_cache_enabled( status_bar_window, true );
+	layer_mark_dirty( status_bar_window_get_status_bar_layer( status_bar_window ) );
+	mock_window_render( window );
+
+	//nothing changed, so the status bar is copied back from the cache in one draw
+	mock_reset_counters();
+	mock_window_render( window );
+	TEST_CHECK_EQUAL( mock_get_counters()->bitmap_draws, 1 );
+	TEST_CHECK_EQUAL( mock_get_counters()->text_draws, 0 );
+
+	//until something does
+	status_bar_item_set_text( s_item_left, "123" );
+	mock_reset_counters();
+	mock_window_render( window );
+	TEST_CHECK( mock_get_counters()->text_draws > 0 );
+
+	test_window_pop( status_bar_window );
+}
+
+static void test_layout_sized_by_shown_items(void){
+	status_bar_window_t *status_bar_window = test_window_push();
+	Window *window = status_bar_window_get_window( status_bar_window );
+	const status_bar_stats_heap_usage_t *layout_heap = &( status_bar_stats_get()->heaps[STATUS_BAR_STATS_HEAP_LAYOUT] );
+	uint32_t layout_bytes = layout_heap->current_bytes;
+
+	//items that aren't shown take no room in the layout
+	for( uint32_t item_id = 100; item_id < 200; item_id++ ){
+		status_bar_item_catalog_insert( status_bar_item_create( GTextAlignmentLeft, STATUS_BAR_BORDER_DISTANCE_CLOSE, item_id, 100, false ) );
+	}
+	status_bar_window_mark_layout_dirty( status_bar_window );
+	mock_reset_counters();
+	mock_window_render( window );
+	TEST_CHECK_EQUAL( layout_heap->current_bytes, layout_bytes );
+	TEST_CHECK( mock_get_counters()->text_draws > 0 );
+
+	test_window_pop( status_bar_window );
+}
+
+static void test_battery_charge_inside_icon(void){
+	status_bar_window_t *status_bar_window = test_window_push();
+	Window *window = status_bar_window_get_window( status_bar_window );
+	layer_mark_dirty( status_bar_window_get_status_bar_layer( status_bar_window ) );
+	mock_reset_counters();
+	mock_window_render( window );
+
+	//the right zone is drawn last, so the last charge is the watch battery's, whose icon is the rightmost one
+	GRect charge_rect = mock_get_counters()->last_fill_rect;
+	TEST_CHECK( charge_rect.size.w > 0 && charge_rect.size.h > 0 );
+	TEST_CHECK( charge_rect.origin.x >= STATUS_BAR_WINDOW_WIDTH - MOCK_ICON_WIDTH - STATUS_BAR_ITEM_DISTANCE );
+	TEST_CHECK( charge_rect.origin.x + charge_rect.size.w <= STATUS_BAR_WINDOW_WIDTH );
+
+	test_window_pop( status_bar_window );
+}
+
+static void test_atlas_load_fails(void){
+	mock_set_resource_load_fails( true );
+	status_bar_window_t *status_bar_window = test_window_push();
+	Window *window = status_bar_window_get_window( status_bar_window );
+
+	//texts are still drawn, without any icon
+	mock_reset_counters();
+	layer_mark_dirty( status_bar_window_get_status_bar_layer( status_bar_window ) );
+	mock_window_render( window );
+	TEST_CHECK( mock_get_counters()->text_draws > 0 );
+	TEST_CHECK_EQUAL( mock_get_counters()->bitmap_draws, 0 );
+	mock_set_battery_state( (BatteryChargeState){ .charge_percent = 50 } );
+	mock_window_render( window );
+
+	//and the atlas is loaded on next build
+	mock_set_resource_load_fails( false );
+	status_bar_window_mark_layout_dirty( status_bar_window );
+	mock_reset_counters();
+	mock_window_render( window );
+	TEST_CHECK( mock_get_counters()->bitmap_draws > 0 );
+
+	test_window_pop( status_bar_window );
+}
+
+
+int main(void){
+	TEST_RUN( test_push_builds_layout_once );
+	TEST_RUN( test_tick_updates_clock_in_place );
+	TEST_RUN( test_battery_updates_in_place );
+	TEST_RUN( test_item_text_updates_in_place );
+	TEST_RUN( test_batch_updates_once );
+	TEST_RUN( test_invalidation_interval_coalesces );
+	TEST_RUN( test_invalidation_interval_covers_in_place_updates );
+	TEST_RUN( test_phone_battery );
+	TEST_RUN( test_seconds_clock );
+	TEST_RUN( test_render_profiles_once_per_zone );
+	TEST_RUN( test_frame_cache );
+	TEST_RUN( test_layout_sized_by_shown_items );
+	TEST_RUN( test_battery_charge_inside_icon );
+	TEST_RUN( test_atlas_load_fails );
+
+	return TEST_RESULT();
+}
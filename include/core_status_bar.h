@@ -1,6 +1,24 @@
 #pragma once
 #include <pebble.h>
 
+
+//-----------//
+// Constants //
+//-----------//
+
+// Item id index (open addressing hash table, kept at most half full)
+#define STATUS_BAR_ITEM_INDEX_MIN_CAPACITY 8		//must be a power of two
+#define STATUS_BAR_ITEM_CATALOG_INIT_MAX_ITEMS 32	//status_bar_item_catalog_init presizes for at most this many items
+
+// Item bitsets (one bit per item, by priority, in groups of STATUS_BAR_ITEM_BITS_PER_GROUP items)
+#define STATUS_BAR_ITEM_APP_FLAG_COUNT 4			//app-defined flags, see status_bar_item_set_app_flags
+#define STATUS_BAR_ITEM_BITS_PER_GROUP 32
+#define STATUS_BAR_ITEM_BITSET_COUNT ( 4 + STATUS_BAR_ITEM_APP_FLAG_COUNT )		//loaded, shown, cached, needs phone, app flags
+#define STATUS_BAR_ITEM_BITSET_WORDS( item_count )	\
+	( ( ( (item_count) + STATUS_BAR_ITEM_BITS_PER_GROUP - 1 ) / STATUS_BAR_ITEM_BITS_PER_GROUP ) * STATUS_BAR_ITEM_BITSET_COUNT )
+#define STATUS_BAR_ITEM_NO_CATALOG_INDEX UINT16_MAX
+
+
 //------------//
 // Data Types //
 //------------//
@@ -15,9 +33,34 @@ typedef enum {
 	STATUS_BAR_BORDER_DISTANCE_SYSTEM_TEXT,
 	STATUS_BAR_BORDER_DISTANCE_CLOSE,
 	STATUS_BAR_BORDER_DISTANCE_MEDIUM,
-	STATUS_BAR_BORDER_DISTANCE_FAR
+	STATUS_BAR_BORDER_DISTANCE_FAR,
+	
+	STATUS_BAR_BORDER_DISTANCE_COUNT
 } status_bar_border_distance_t;
 
+//status bar custom items (only public so they can be declared statically, use the functions below instead of the fields)
+struct status_bar_item_s {
+	GTextAlignment alignment;
+	status_bar_border_distance_t distance;
+	
+	uint32_t id;
+	uint32_t icon_resource_id;
+	GBitmap *icon_atlas;		//if not NULL, icon is cut from this atlas instead of loaded from icon_resource_id
+	GRect icon_atlas_slot;
+	bool requires_phone_connection;
+	uint8_t app_flags;			//see status_bar_item_set_app_flags
+	
+	bool is_visible;			//set by status_bar_item_load_icon, cleared by status_bar_item_unload_icon
+	GBitmap *icon;				//NULL if not loaded, or evicted from the icon cache
+	size_t icon_size;			//bytes accounted for icon in the icon cache
+	uint32_t icon_last_used;
+	char *text;
+	
+	bool is_static;				//declared with STATUS_BAR_ITEM_CATALOG_DEFINE, so it's never freed
+	uint16_t catalog_index;		//priority position, i.e. the item's bit in the catalog's bitsets
+	status_bar_item_t *next;
+};
+
 
 //------------------//
 // Status Bar Items //
@@ -38,7 +81,8 @@ void status_bar_item_destroy_recursive( status_bar_item_t *item );
 GTextAlignment status_bar_item_get_alignment( status_bar_item_t *item );
 status_bar_border_distance_t status_bar_item_get_distance( status_bar_item_t *item );
 bool status_bar_item_get_requires_phone_connection( status_bar_item_t *item );	
-GBitmap *status_bar_item_get_icon( status_bar_item_t *item );
+GBitmap *status_bar_item_get_icon( status_bar_item_t *item );		//NULL if icon isn't loaded, or was evicted from the icon cache
+bool status_bar_item_get_visible( status_bar_item_t *item );			//true between status_bar_item_load_icon and status_bar_item_unload_icon
 char *status_bar_item_get_text( status_bar_item_t *item );	
 status_bar_item_t *status_bar_item_get_next( status_bar_item_t *item );
 
@@ -47,6 +91,9 @@ void status_bar_item_set_text( status_bar_item_t *item, char *text );
 void status_bar_item_load_new_icon( status_bar_item_t *item, uint32_t icon_resource_id );
 void status_bar_item_load_icon( status_bar_item_t *item );
 void status_bar_item_unload_icon( status_bar_item_t *item );
+void status_bar_item_set_icon_atlas_slot( status_bar_item_t *item, GBitmap *atlas, GRect slot );	//icon becomes a sub-bitmap of an app-owned atlas
+GBitmap *status_bar_item_use_icon( status_bar_item_t *item );		//returns icon, reloading it if it was evicted from the icon cache
+void status_bar_item_set_app_flags( status_bar_item_t *item, uint8_t app_flags );		//see status_bar_item_catalog_set_hidden_app_flags
 	
 
 //-------------------------//
@@ -54,12 +101,91 @@ void status_bar_item_unload_icon( status_bar_item_t *item );
 //-------------------------//
 
 //constructor, destructor
-void status_bar_item_catalog_init( size_t item_id_count );
+void status_bar_item_catalog_init( size_t item_id_count );		//item_id_count is only a hint (capped), the catalog grows on insert
+void status_bar_item_catalog_init_static(			//see STATUS_BAR_ITEM_CATALOG_DEFINE
+	status_bar_item_t *items,
+	size_t item_count,
+	status_bar_item_t * const *id_table,
+	size_t item_id_count,
+	uint32_t *item_bits								//STATUS_BAR_ITEM_BITSET_WORDS( item_count ) words
+);
 void status_bar_item_catalog_deinit(void);
 
 //getters
 status_bar_item_t *status_bar_item_catalog_find( uint32_t item_id );
 status_bar_item_t *status_bar_item_catalog_get_first(void);
+status_bar_item_t *status_bar_item_catalog_get_first_shown(void);		//items that can be on screen, by priority
+status_bar_item_t *status_bar_item_catalog_get_next_shown( status_bar_item_t *item );
+size_t status_bar_item_catalog_get_count(void);
+size_t status_bar_item_catalog_get_shown_count(void);		//items status_bar_item_catalog_get_first_shown iterates over
+size_t status_bar_item_catalog_get_icon_resident_bytes(void);
+uint32_t status_bar_item_catalog_get_icon_eviction_count(void);
 
 //setters
-void status_bar_item_catalog_insert( status_bar_item_t *item );		//inserts with lower priority than last
+void status_bar_item_catalog_insert( status_bar_item_t *item );		//inserts with lower priority than last (destroys item if there's no room)
+
+//icon cache: icons of hidden items (or of items waiting for a phone connection) stay loaded until the budget is exceeded,
+//and are then evicted least recently used first (0 means no budget, and hidden icons are freed right away).
+//the budget is enforced after each update, or once when a batch commits
+void status_bar_item_catalog_set_icon_budget( size_t icon_budget );
+void status_bar_item_catalog_set_is_connected_to_phone( bool connected );
+
+//shown items: items with a loaded icon, unless they require a phone connection while there's none,
+//or have any of the app flags (lowest STATUS_BAR_ITEM_APP_FLAG_COUNT bits) hidden with this (e.g. per screen of the app)
+void status_bar_item_catalog_set_hidden_app_flags( uint8_t app_flags );
+
+//batches: item changes between begin and commit update the status bar only once, on commit (batches can be nested)
+void status_bar_item_catalog_begin_update(void);
+void status_bar_item_catalog_commit_update(void);
+
+
+//----------------------------//
+// Static Status Bar Catalogs //
+//----------------------------//
+
+//declares a whole catalog at compile time: items, id_table and priority order are static data, so no heap is used.
+//ITEMS is an X-macro listing items by priority (one ITEM per line, lines joined with backslashes),
+//and item ids must be single tokens (e.g. enum values), as in:
+//
+//	#define MY_STATUS_BAR_ITEMS( ITEM )
+//		ITEM( MY_ITEM_ALARM, GTextAlignmentLeft, STATUS_BAR_BORDER_DISTANCE_CLOSE, RESOURCE_ID_ALARM, false )
+//		ITEM( MY_ITEM_MAIL, GTextAlignmentRight, STATUS_BAR_BORDER_DISTANCE_FAR, RESOURCE_ID_MAIL, true )
+//
+//	STATUS_BAR_ITEM_CATALOG_DEFINE( MY_STATUS_BAR_ITEMS, MY_ITEM_COUNT )
+//
+//	//then, instead of status_bar_item_catalog_init and status_bar_item_catalog_insert:
+//	STATUS_BAR_ITEM_CATALOG_INIT_STATIC();
+//
+//static catalogs can't take more items with status_bar_item_catalog_insert.
+#define STATUS_BAR_ITEM_CATALOG_DEFINE( ITEMS, item_id_count )																\
+	enum { ITEMS( STATUS_BAR_STATIC_ITEM_INDEX ) STATUS_BAR_STATIC_ITEM_COUNT };											\
+	static status_bar_item_t s_status_bar_static_items[] = { ITEMS( STATUS_BAR_STATIC_ITEM ) };						\
+	static status_bar_item_t * const s_status_bar_static_id_table[item_id_count] = { ITEMS( STATUS_BAR_STATIC_ITEM_ID ) };	\
+	static uint32_t s_status_bar_static_item_bits[STATUS_BAR_ITEM_BITSET_WORDS( STATUS_BAR_STATIC_ITEM_COUNT )];
+
+#define STATUS_BAR_ITEM_CATALOG_INIT_STATIC()			\
+	status_bar_item_catalog_init_static(				\
+		s_status_bar_static_items,						\
+		STATUS_BAR_STATIC_ITEM_COUNT,					\
+		s_status_bar_static_id_table,					\
+		ARRAY_LENGTH( s_status_bar_static_id_table ),	\
+		s_status_bar_static_item_bits					\
+	)
+
+//STATUS_BAR_ITEM_CATALOG_DEFINE helpers (each item in ITEMS expands to its index, its item, and its id_table entry)
+#define STATUS_BAR_STATIC_ITEM_INDEX( item_id, alignment_, distance_, icon_resource_id_, requires_phone_connection_ )	\
+	STATUS_BAR_STATIC_ITEM_INDEX_##item_id,
+
+#define STATUS_BAR_STATIC_ITEM( item_id, alignment_, distance_, icon_resource_id_, requires_phone_connection_ )		\
+	{																												\
+		.alignment = alignment_,																					\
+		.distance = distance_,																						\
+		.id = item_id,																								\
+		.icon_resource_id = icon_resource_id_,																		\
+		.requires_phone_connection = requires_phone_connection_,													\
+		.catalog_index = STATUS_BAR_ITEM_NO_CATALOG_INDEX,															\
+		.is_static = true																							\
+	},
+
+#define STATUS_BAR_STATIC_ITEM_ID( item_id, alignment_, distance_, icon_resource_id_, requires_phone_connection_ )	\
+	[item_id] = &( s_status_bar_static_items[STATUS_BAR_STATIC_ITEM_INDEX_##item_id] ),
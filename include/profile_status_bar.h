@@ -0,0 +1,73 @@
+#pragma once
+#include <pebble.h>
+#include "stats_status_bar.h"
+
+
+//-----------//
+// Constants //
+//-----------//
+
+// Profiling hooks are only compiled in when STATUS_BAR_ENABLE_PROFILING is defined (e.g. through the app's CFLAGS).
+// Otherwise, the macros below compile to nothing at all.
+#ifdef STATUS_BAR_ENABLE_PROFILING
+	#define STATUS_BAR_PROFILE_START( sample ) uint32_t sample = STATUS_BAR_PROFILE_CLOCK()
+	#define STATUS_BAR_PROFILE_STOP( sample, point ) status_bar_profile_record( point, STATUS_BAR_PROFILE_CLOCK() - sample )
+#else
+	#define STATUS_BAR_PROFILE_START( sample )
+	#define STATUS_BAR_PROFILE_STOP( sample, point )
+#endif
+
+// Clock used by the hooks: milliseconds from time_ms by default (host builds can define it as a cycle counter instead)
+#ifndef STATUS_BAR_PROFILE_CLOCK
+	#define STATUS_BAR_PROFILE_CLOCK() status_bar_stats_get_time_ms()
+#endif
+
+// Histograms (a finer clock needs more buckets, e.g. host builds timed in cycles)
+#ifndef STATUS_BAR_PROFILE_HISTOGRAM_BUCKETS
+	#define STATUS_BAR_PROFILE_HISTOGRAM_BUCKETS 8		//bucket 0 counts samples of 0 ticks, bucket i of [2^(i-1), 2^i) ticks, and the last one everything above
+#endif
+
+
+//------------//
+// Data Types //
+//------------//
+
+// Profiled points (rendering is profiled per item type, one sample per type and zone)
+typedef enum {
+	STATUS_BAR_PROFILE_POINT_BUILD_LAYOUT,
+	STATUS_BAR_PROFILE_POINT_TICK_HANDLER,
+	STATUS_BAR_PROFILE_POINT_BATTERY_HANDLER,
+	STATUS_BAR_PROFILE_POINT_CONNECTION_HANDLER,
+	
+	STATUS_BAR_PROFILE_POINT_RENDER_TIME,
+	STATUS_BAR_PROFILE_POINT_RENDER_TIME_SUFFIX,
+	STATUS_BAR_PROFILE_POINT_RENDER_BATTERY_ICON,
+	STATUS_BAR_PROFILE_POINT_RENDER_PHONE_ICON,
+	STATUS_BAR_PROFILE_POINT_RENDER_BATTERY_TEXT,
+	STATUS_BAR_PROFILE_POINT_RENDER_CATALOG_ITEM,
+	
+	STATUS_BAR_PROFILE_POINT_COUNT
+} status_bar_profile_point_t;
+
+typedef struct status_bar_profile_histogram_s {
+	uint32_t count;
+	uint32_t total;
+	uint32_t max;
+	uint32_t buckets[STATUS_BAR_PROFILE_HISTOGRAM_BUCKETS];
+} status_bar_profile_histogram_t;
+
+
+//-----------//
+// Profiling //
+//-----------//
+
+//getters
+const status_bar_profile_histogram_t *status_bar_profile_get_histogram( status_bar_profile_point_t point );
+
+//setters
+void status_bar_profile_reset(void);
+void status_bar_profile_record( status_bar_profile_point_t point, uint32_t elapsed );
+
+//logging (one summary line per profiled point, either now or every interval_ms until stopped with 0)
+void status_bar_profile_log(void);
+void status_bar_profile_set_log_interval( uint32_t interval_ms );
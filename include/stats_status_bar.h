@@ -0,0 +1,120 @@
+#pragma once
+#include <pebble.h>
+
+
+//-----------//
+// Constants //
+//-----------//
+
+// Statistics are only collected when STATUS_BAR_ENABLE_STATS is defined (e.g. through the app's CFLAGS).
+// Otherwise, the macros below compile to the plain libc calls, or to nothing at all.
+// Allocations are accounted to one of the heaps in status_bar_stats_heap_t (bitmaps are tracked separately, by size).
+#ifdef STATUS_BAR_ENABLE_STATS
+	#define STATUS_BAR_MALLOC( heap, size ) status_bar_stats_malloc( heap, size )
+	#define STATUS_BAR_CALLOC( heap, count, size ) status_bar_stats_calloc( heap, count, size )
+	#define STATUS_BAR_FREE( ptr ) status_bar_stats_free( ptr )
+	#define STATUS_BAR_STATS_HEAP_TRACK( heap, bytes ) status_bar_stats_heap_track( heap, bytes )
+	#define STATUS_BAR_STATS_HEAP_UNTRACK( heap, bytes ) status_bar_stats_heap_untrack( heap, bytes )
+	
+	#define STATUS_BAR_STATS_TIMER_START( timer ) uint32_t timer = status_bar_stats_get_time_ms()
+	#define STATUS_BAR_STATS_TIMER_STOP( timer, event ) status_bar_stats_record_event( event, status_bar_stats_get_time_ms() - timer )
+	#define STATUS_BAR_STATS_INCREMENT( counter ) status_bar_stats_increment( counter )
+#else
+	#define STATUS_BAR_MALLOC( heap, size ) malloc( size )
+	#define STATUS_BAR_CALLOC( heap, count, size ) calloc( count, size )
+	#define STATUS_BAR_FREE( ptr ) free( ptr )
+	#define STATUS_BAR_STATS_HEAP_TRACK( heap, bytes )
+	#define STATUS_BAR_STATS_HEAP_UNTRACK( heap, bytes )
+	
+	#define STATUS_BAR_STATS_TIMER_START( timer )
+	#define STATUS_BAR_STATS_TIMER_STOP( timer, event )
+	#define STATUS_BAR_STATS_INCREMENT( counter )
+#endif
+
+
+//------------//
+// Data Types //
+//------------//
+
+// Timed events
+typedef enum {
+	STATUS_BAR_STATS_EVENT_BUILD_LAYOUT,
+	STATUS_BAR_STATS_EVENT_RENDER,
+	STATUS_BAR_STATS_EVENT_TICK,
+	STATUS_BAR_STATS_EVENT_BATTERY,
+	STATUS_BAR_STATS_EVENT_CONNECTION,
+	
+	STATUS_BAR_STATS_EVENT_COUNT
+} status_bar_stats_event_t;
+
+// Counters
+typedef enum {
+	STATUS_BAR_STATS_COUNTER_TEXT_CACHE_HIT,
+	STATUS_BAR_STATS_COUNTER_TEXT_CACHE_MISS,
+	STATUS_BAR_STATS_COUNTER_GLYPH_TABLE_HIT,		//texts measured by summing glyph advances
+	STATUS_BAR_STATS_COUNTER_SUPPRESSED_TICK,		//tick events that didn't change the clock texts
+	STATUS_BAR_STATS_COUNTER_SUPPRESSED_BATTERY,	//battery events that didn't change the battery icon or text
+	STATUS_BAR_STATS_COUNTER_SUPPRESSED_PHONE_BATTERY,	//phone battery updates that didn't change the phone's charge state
+	STATUS_BAR_STATS_COUNTER_COALESCED_PHONE_BATTERY,	//phone battery updates replaced by a newer one before being applied
+	
+	STATUS_BAR_STATS_COUNTER_COUNT
+} status_bar_stats_counter_t;
+
+// Heaps (library subsystems whose allocations are accounted separately)
+typedef enum {
+	STATUS_BAR_STATS_HEAP_CATALOG,		//catalog, its items, id index and icons
+	STATUS_BAR_STATS_HEAP_LAYOUT,		//window layouts, their items and display lists
+	STATUS_BAR_STATS_HEAP_RESOURCES,	//bitmaps shared between windows
+	STATUS_BAR_STATS_HEAP_WINDOW,		//windows, their globals and frame caches
+	
+	STATUS_BAR_STATS_HEAP_COUNT
+} status_bar_stats_heap_t;
+
+typedef struct status_bar_stats_heap_usage_s {
+	uint32_t current_bytes;
+	uint32_t peak_bytes;
+	uint32_t alloc_count;
+	uint32_t free_count;
+} status_bar_stats_heap_usage_t;
+
+typedef struct status_bar_stats_timing_s {
+	uint32_t count;
+	uint32_t total_ms;
+	uint32_t max_ms;
+} status_bar_stats_timing_t;
+
+typedef struct status_bar_stats_s {
+	status_bar_stats_timing_t events[STATUS_BAR_STATS_EVENT_COUNT];
+	uint32_t counters[STATUS_BAR_STATS_COUNTER_COUNT];
+	
+	status_bar_stats_heap_usage_t heaps[STATUS_BAR_STATS_HEAP_COUNT];
+	status_bar_stats_heap_usage_t heap_total;		//all heaps together (its peak isn't the sum of their peaks)
+} status_bar_stats_t;
+
+
+//------------//
+// Statistics //
+//------------//
+
+//getters
+const status_bar_stats_t *status_bar_stats_get(void);
+uint32_t status_bar_stats_get_time_ms(void);		//milliseconds from time_ms (always compiled, the window's timers use it too)
+
+//setters
+void status_bar_stats_reset(void);
+void status_bar_stats_record_event( status_bar_stats_event_t event, uint32_t elapsed_ms );
+void status_bar_stats_increment( status_bar_stats_counter_t counter );
+
+//logging (average time per event, counters, heap usage)
+void status_bar_stats_log(void);
+void status_bar_stats_log_heap(void);
+
+//accounted allocations (each one is prefixed with its size and heap, so frees are accounted too)
+void *status_bar_stats_malloc( status_bar_stats_heap_t heap, size_t size );
+void *status_bar_stats_calloc( status_bar_stats_heap_t heap, size_t count, size_t size );
+void status_bar_stats_free( void *ptr );
+
+//accounting for memory allocated elsewhere (e.g. bitmaps)
+void status_bar_stats_heap_track( status_bar_stats_heap_t heap, size_t bytes );
+void status_bar_stats_heap_untrack( status_bar_stats_heap_t heap, size_t bytes );
+size_t status_bar_stats_get_bitmap_bytes( GBitmap *bitmap );		//pixel data of a bitmap
@@ -40,6 +40,8 @@
 //Battery Regions
 #define STATUS_BAR_BATTERY_CHARGE_MAX 100
 #define STATUS_BAR_BATTERY_CHARGE_THRESHOLD 30
+#define STATUS_BAR_BATTERY_CHARGE_STEP 10		//charge levels reported by the battery service
+#define STATUS_BAR_BATTERY_CHARGE_LEVELS ( STATUS_BAR_BATTERY_CHARGE_MAX / STATUS_BAR_BATTERY_CHARGE_STEP + 1 )
 
 #define STATUS_BAR_WATCH_FULL_MISSING_PERCENT 20
 #define STATUS_BAR_WATCH_EMPTY_MISSING_PERCENT 100
@@ -51,15 +53,53 @@
 #define STATUS_BAR_PHONE_BATTERY_X 3
 #define STATUS_BAR_PHONE_BATTERY_Y 3
 
+// Phone battery, sent by the phone as a single uint8 under MESSAGE_KEY_STATUS_BAR_PHONE_BATTERY (see README)
+#define STATUS_BAR_PHONE_BATTERY_CHARGING_FLAG 0x80		//set while the phone is charging
+#define STATUS_BAR_PHONE_BATTERY_LEVEL_MASK 0x0F		//charge, in STATUS_BAR_BATTERY_CHARGE_STEP units
+#define STATUS_BAR_PHONE_BATTERY_INTERVAL_MS_DEFAULT 1000		//updates arriving closer than this are coalesced into one
+
+
+// Shared resources
+#define STATUS_BAR_RESOURCE_KEEP_ALIVE_MS_DEFAULT 0		//by default, bitmaps are freed as soon as the last window is destroyed
+
+// Invalidation scheduler
+#define STATUS_BAR_INVALIDATION_INTERVAL_MS_DEFAULT 0		//by default, every invalidation redraws right away
+
+// Icon atlas slots (must match the output of tools/pack_status_bar_atlas.py)
+#define STATUS_BAR_ATLAS_SLOT_PHONE GRect(0, 0, 11, 16)
+#define STATUS_BAR_ATLAS_SLOT_BATTERY GRect(11, 0, 11, 16)
+#define STATUS_BAR_ATLAS_SLOT_CHARGING GRect(22, 0, 5, 8)
+#define STATUS_BAR_ATLAS_SLOT_CHARGING_HALF GRect(27, 0, 5, 8)
+
+
+// Text measurement cache
+#define STATUS_BAR_TEXT_CACHE_SIZE 8				//number of measured texts remembered
+#define STATUS_BAR_TEXT_CACHE_KEY_SIZE 16			//texts at least this long are measured every time
+
+
+// Glyph advance tables (texts made only of these glyphs are measured without the text layout engine)
+#define STATUS_BAR_GLYPH_TABLE_GLYPHS "0123456789:AMP"		//digits first, so a digit's index is its value
+#define STATUS_BAR_GLYPH_TABLE_SIZE 14
+#define STATUS_BAR_GLYPH_TABLE_SEPARATOR 10				//index of ':'
+
+
+// Layouts
+#define STATUS_BAR_LAYOUT_BATTERY_CAPACITY 2		//number of layout items that can show a battery charge
+#define STATUS_BAR_LAYOUT_COMMANDS_PER_ITEM 2		//display list commands an item can compile to (icon, text)
+#define STATUS_BAR_LAYOUT_COMMANDS_PER_BATTERY 1	//and one more for a battery item's charging glyph or charge
+
 
 // Text buffers
-#define STATUS_BAR_TIME_TEXT_BUFFER_SIZE 6			//"mm:ss"
+#define STATUS_BAR_TIME_TEXT_BUFFER_SIZE 9			//"hh:mm:ss"
 #define STATUS_BAR_TIME_SUFFIX_TEXT_BUFFER_SIZE 3	//"PM"
 #define STATUS_BAR_BATTERY_TEXT_BUFFER_SIZE 4		//"100"
 
 
 // Service Handlers
 #define STATUS_BAR_WINDOW_TICK_UNITS ( MINUTE_UNIT | HOUR_UNIT )
+#define STATUS_BAR_WINDOW_TICK_UNITS_SECONDS ( SECOND_UNIT | MINUTE_UNIT | HOUR_UNIT )		//when seconds are shown
+#define STATUS_BAR_SECONDS_CLOCK_DIGITS 6			//"hh:mm:ss", for sizing the seconds clock's slot
+#define STATUS_BAR_SECONDS_CLOCK_SEPARATORS 2
 
 
 // Colors and Image Compositing Modes
@@ -87,10 +127,32 @@ typedef struct status_bar_window_layout_item_parts_s {
 	int battery_full_missing_percent;	//how much charge% can be missing, and still show a full battery icon
 	int battery_empty_missing_percent;	//how much charge% needs to be missing, for battery icon to show as empty
 	GPoint battery_icon_origin;
+	
+	GSize text_fixed_size;			//if not zero, text always takes this room (and is never measured)
 } status_bar_window_layout_item_parts_t;
 
 typedef struct status_bar_window_layout_item_s status_bar_window_layout_item_t;
 typedef struct status_bar_window_layout_s status_bar_window_layout_t;
+
+//status bar zones, each with its own display list (all replayed by the status bar layer, one after another)
+typedef enum {
+	STATUS_BAR_WINDOW_ZONE_LEFT,
+	STATUS_BAR_WINDOW_ZONE_CENTER,
+	STATUS_BAR_WINDOW_ZONE_RIGHT,
+	
+	STATUS_BAR_WINDOW_ZONE_COUNT
+} status_bar_window_zone_t;
+
+//layout items shown by the status bar itself, which can be updated in place
+typedef enum {
+	STATUS_BAR_WINDOW_SYSTEM_ITEM_TIME,
+	STATUS_BAR_WINDOW_SYSTEM_ITEM_TIME_SUFFIX,
+	STATUS_BAR_WINDOW_SYSTEM_ITEM_BATTERY_ICON,
+	STATUS_BAR_WINDOW_SYSTEM_ITEM_PHONE_ICON,
+	STATUS_BAR_WINDOW_SYSTEM_ITEM_BATTERY_TEXT,
+	
+	STATUS_BAR_WINDOW_SYSTEM_ITEM_COUNT
+} status_bar_window_system_item_t;
 	
 //status bar windows themselves, and the data globally shared between them
 typedef struct status_bar_window_s status_bar_window_t;
@@ -103,33 +165,44 @@ typedef struct status_bar_window_globals_s status_bar_window_globals_t;
 //--------------------------------//
 	
 status_bar_window_layout_item_t *status_bar_window_layout_item_create(
+	status_bar_window_layout_t *status_bar_window_layout,
 	GTextAlignment alignment,
 	status_bar_border_distance_t distance,
-	status_bar_window_layout_item_parts_t item_parts
+	status_bar_window_layout_item_parts_t item_parts,
+	status_bar_item_t *source
 );
-void status_bar_window_layout_item_destroy( status_bar_window_layout_item_t *item );
-void status_bar_window_layout_item_destroy_recursive( status_bar_window_layout_item_t *item );
+void status_bar_window_layout_item_update_width( status_bar_window_layout_item_t *item );
 
-int8_t status_bar_window_layout_item_render_icon( status_bar_window_layout_item_t *item, GContext *ctx, int8_t offset_x );
-int8_t status_bar_window_layout_item_render_text( status_bar_window_layout_item_t *item, GContext *ctx, int8_t offset_x );
-int8_t status_bar_window_layout_item_render( status_bar_window_layout_item_t *item, GContext *ctx, int8_t offset_x );
+int8_t status_bar_window_layout_item_place( status_bar_window_layout_item_t *item, int8_t offset_x );	//returns the new offset_x
 
 
 //--------------------------//
 // Status Bar Window Layout //
 //--------------------------//
 
-status_bar_window_layout_t *status_bar_window_layout_create(void);
+status_bar_window_layout_t *status_bar_window_layout_create( size_t item_capacity );
+void status_bar_window_layout_reset( status_bar_window_layout_t *status_bar_window_layout );		//drops all items, in O(1)
 void status_bar_window_layout_destroy( status_bar_window_layout_t *status_bar_window_layout );
 
-bool status_bar_window_layout_add_item(		//returns true if successfully added, false if item wouldn't fit
+status_bar_window_layout_item_t *status_bar_window_layout_add_item(		//returns the added item, or NULL if it wouldn't fit
 	status_bar_window_layout_t *status_bar_window_layout,
 	GTextAlignment alignment,
 	status_bar_border_distance_t distance,
-	status_bar_window_layout_item_parts_t item_parts
+	status_bar_window_layout_item_parts_t item_parts,
+	status_bar_item_t *source
+);
+void status_bar_window_layout_finish( status_bar_window_layout_t *status_bar_window_layout );	//puts items in render order, after the last add
+void status_bar_window_layout_compile( status_bar_window_layout_t *status_bar_window_layout );		//builds the display list from the items
+void status_bar_window_layout_render_zone( status_bar_window_layout_t *status_bar_window_layout, status_bar_window_zone_t zone, GContext *ctx );
+bool status_bar_window_layout_update_item(		//returns true if item was updated in place, false if layout must be rebuilt
+	status_bar_window_layout_t *status_bar_window_layout,
+	status_bar_window_layout_item_t *item
 );
 
-void status_bar_window_mark_layout_dirty( status_bar_window_t *status_bar_window );
+void status_bar_window_mark_layout_dirty( status_bar_window_t *status_bar_window );		//rebuilds the whole layout
+void status_bar_window_flush_invalidation( status_bar_window_t *status_bar_window );	//redraws now, even if the frame interval hasn't passed
+void status_bar_window_mark_system_item_dirty( status_bar_window_t *status_bar_window, status_bar_window_system_item_t system_item );
+void status_bar_window_mark_item_dirty( status_bar_window_t *status_bar_window, status_bar_item_t *source );
 void status_bar_window_build_layout( status_bar_window_t *status_bar_window );
 
 
@@ -142,6 +215,26 @@ status_bar_window_t *status_bar_window_create( bool hide_time );
 void status_bar_window_destroy( status_bar_window_t *status_bar_window );
 
 
+//------------------//
+// Shared Resources //
+//------------------//
+
+//how long bitmaps stay loaded after the last window is destroyed (so a quickly pushed new window doesn't reload them)
+void status_bar_window_set_resource_keep_alive( uint32_t keep_alive_ms );
+
+
+
+//---------------//
+// Phone Battery //
+//---------------//
+
+//to be called from the app's AppMessage inbox handler, returns true if the message carried a phone battery update
+bool status_bar_window_handle_app_message( DictionaryIterator *iterator );
+
+//phone battery updates are applied at most once per interval (the latest one wins), 0 means every update is applied right away
+void status_bar_window_set_phone_battery_interval( uint32_t interval_ms );
+
+
 //---------------------//
 // Getters and Setters //
 //---------------------//
@@ -152,6 +245,18 @@ status_bar_window_t *window_get_status_bar_window( Window *window );
 Window *status_bar_window_get_window(status_bar_window_t *status_bar_window );
 Layer *status_bar_window_get_status_bar_layer(status_bar_window_t *status_bar_window );
 Layer *status_bar_window_get_body_layer(status_bar_window_t *status_bar_window );
+status_bar_window_layout_t *status_bar_window_get_layout( status_bar_window_t *status_bar_window );		//NULL until first built
+
+//when enabled, the rendered status bar is kept in an offscreen bitmap, and redrawn from it until something changes
+void status_bar_window_set_frame_cache_enabled( status_bar_window_t *status_bar_window, bool enabled );
+
+//invalidations (in-place updates included) are coalesced into at most one redraw per interval, 0 means no coalescing
+void status_bar_window_set_invalidation_interval( status_bar_window_t *status_bar_window, uint32_t interval_ms );
+uint32_t status_bar_window_get_rebuild_count( status_bar_window_t *status_bar_window );
+uint32_t status_bar_window_get_redraw_count( status_bar_window_t *status_bar_window );
+
+//shows seconds in the clock, which then gets a fixed-width slot (so each second only updates the clock text, with no layout work)
+void status_bar_window_set_seconds_enabled( status_bar_window_t *status_bar_window, bool enabled );
 
 
 //----------------------------------------//
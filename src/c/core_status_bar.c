@@ -1,32 +1,61 @@
 #include <pebble.h>
 #include "include/core_status_bar.h"
 #include "include/window_status_bar.h"
+#include "include/stats_status_bar.h"
+
+
+//-----------//
+// Constants //
+//-----------//
+
+//bitsets within each group of STATUS_BAR_ITEM_BITSET_COUNT words
+#define STATUS_BAR_ITEM_BITS_LOADED 0			//icon loaded (is_visible)
+#define STATUS_BAR_ITEM_BITS_SHOWN 1			//can be on screen, kept up to date from the others
+#define STATUS_BAR_ITEM_BITS_CACHED 2			//icon bitmap resident in the icon cache (icon isn't NULL)
+#define STATUS_BAR_ITEM_BITS_NEEDS_PHONE 3		//requires_phone_connection (this and the app flags are the hiding bitsets)
+#define STATUS_BAR_ITEM_BITS_APP_FLAGS 4		//one bitset per app flag, from here on
 
 
 //------------//
 // Data Types //
 //------------//
 
-//status bar custom items and respective catalog
-struct status_bar_item_s {
-	GTextAlignment alignment;
-	status_bar_border_distance_t distance;
-	
-	uint32_t id;
-	uint32_t icon_resource_id;
-	bool requires_phone_connection;
-	
-	GBitmap *icon;
-	char *text;
-	
-	status_bar_item_t *next;
-};
-
+//status bar item catalog (items themselves are declared in the header, so catalogs can be defined statically)
 struct status_bar_item_catalog_s {
 	status_bar_item_t *first;
 	status_bar_item_t **last_next_ptr;
+	size_t count;
+	
+	//items by id: an open addressing hash table (capacity is a power of two, and it's kept at most half full)
+	status_bar_item_t **id_index;
+	size_t id_index_capacity;
+	size_t id_index_count;
 	
-	status_bar_item_t **id_table;		//array of pointers to items: id_table[item_id] points to the item with that id.
+	//static catalogs look up items in the app's own id_table instead (see STATUS_BAR_ITEM_CATALOG_DEFINE)
+	status_bar_item_t * const *id_table;
+	size_t id_count;
+	bool is_static;
+	
+	//bitsets, one bit per item by priority (see STATUS_BAR_ITEM_BITSET_WORDS), and the items by priority
+	//(static catalogs use the app's item array, runtime ones item_table, which grows as items are inserted)
+	uint32_t *item_bits;
+	size_t item_capacity;				//items that have bits (runtime catalogs grow it in powers of two)
+	status_bar_item_t **item_table;
+	status_bar_item_t *static_items;
+	uint8_t hiding_bitsets;				//bitsets whose items can't be shown (bit 0 needs phone, then app flags)
+	size_t shown_count;					//items with their shown bit set
+	
+	//icon cache (a budget of 0 means unlimited, and icons are freed as soon as they're unloaded)
+	size_t icon_budget;
+	size_t icon_resident_bytes;
+	uint32_t icon_eviction_count;
+	uint32_t icon_uses;
+	
+	//batched updates (see status_bar_item_catalog_begin_update)
+	uint8_t batch_depth;
+	bool is_batch_layout_dirty;
+	bool is_batch_trim_pending;			//icon budget is enforced once, at commit
+	status_bar_item_t *batch_dirty_item;	//only item whose text changed during the batch, if no other change happened
 };
 
 
@@ -34,7 +63,8 @@ struct status_bar_item_catalog_s {
 // Static vars //
 //-------------//
 
-static status_bar_item_catalog_t *s_status_bar_item_catalog = NULL;
+static status_bar_item_catalog_t s_status_bar_item_catalog_storage;
+static status_bar_item_catalog_t *s_status_bar_item_catalog = NULL;		//points to s_status_bar_item_catalog_storage while initialized
 
 
 //------------------//
@@ -49,26 +79,101 @@ status_bar_item_t *status_bar_item_create(
 	uint32_t icon_resource_id,
 	bool requires_phone_connection
 ){
-	status_bar_item_t *item = malloc( sizeof(*item) );
+	status_bar_item_t *item = STATUS_BAR_MALLOC( STATUS_BAR_STATS_HEAP_CATALOG, sizeof(*item) );
 	
 	item->alignment = alignment;
 	item->distance = distance;
 	item->id = item_id;
 	item->icon_resource_id = icon_resource_id;
+	item->icon_atlas = NULL;
+	item->icon_atlas_slot = GRectZero;
 	item->requires_phone_connection = requires_phone_connection;
+	item->app_flags = 0;
+	item->is_visible = false;
 	item->icon = NULL;
+	item->icon_size = 0;
+	item->icon_last_used = 0;
 	item->text = NULL;
+	item->is_static = false;
+	item->catalog_index = STATUS_BAR_ITEM_NO_CATALOG_INDEX;
 	item->next = NULL;
 	
 	return item;
 }
 
-void status_bar_item_destroy( status_bar_item_t *item ){
+//item bitsets (only kept for items inserted in the catalog)
+static inline uint32_t *status_bar_item_catalog_get_group_bits( size_t catalog_index ){
+	return &( s_status_bar_item_catalog->item_bits[( catalog_index / STATUS_BAR_ITEM_BITS_PER_GROUP ) * STATUS_BAR_ITEM_BITSET_COUNT] );
+}
+
+static inline void status_bar_item_set_bit( uint32_t *bits, uint32_t bit, bool is_set ){
+	*bits = is_set ? ( *bits | bit ) : ( *bits & ~bit );
+}
+
+static inline status_bar_item_t *status_bar_item_catalog_get_item( size_t catalog_index ){
+	return s_status_bar_item_catalog->is_static ?
+		&( s_status_bar_item_catalog->static_items[catalog_index] ) : s_status_bar_item_catalog->item_table[catalog_index];
+}
+
+//resident bytes only count icons of items in the catalog (insertion adds whatever icon the item already has)
+static inline bool status_bar_item_is_in_catalog( status_bar_item_t *item ){
+	return NULL != s_status_bar_item_catalog && STATUS_BAR_ITEM_NO_CATALOG_INDEX != item->catalog_index;
+}
+
+static inline void status_bar_item_set_cached_bit( status_bar_item_t *item ){
+	status_bar_item_set_bit(
+		&( status_bar_item_catalog_get_group_bits( item->catalog_index )[STATUS_BAR_ITEM_BITS_CACHED] ),
+		(uint32_t)1 << ( item->catalog_index % STATUS_BAR_ITEM_BITS_PER_GROUP ),
+		NULL != item->icon
+	);
+}
+
+//loads and unloads icons, keeping track of the icon cache's resident bytes
+static void status_bar_item_alloc_icon( status_bar_item_t *item ){
+	if( NULL != item->icon_atlas ){
+		item->icon = gbitmap_create_as_sub_bitmap( item->icon_atlas, item->icon_atlas_slot );
+		item->icon_size = 0;						//pixels belong to the app's atlas
+	} else {
+		item->icon = gbitmap_create_with_resource( item->icon_resource_id );
+		item->icon_size = ( NULL == item->icon ) ? 0 :
+			gbitmap_get_bytes_per_row( item->icon ) * gbitmap_get_bounds( item->icon ).size.h;
+	}
+	
 	if( NULL != item->icon ){
-		gbitmap_destroy( item->icon );
+		STATUS_BAR_STATS_HEAP_TRACK( STATUS_BAR_STATS_HEAP_CATALOG, item->icon_size );
+	}
+	
+	if( status_bar_item_is_in_catalog( item ) ){
+		s_status_bar_item_catalog->icon_resident_bytes += item->icon_size;
+		status_bar_item_set_cached_bit( item );
+	}
+}
+
+static void status_bar_item_free_icon( status_bar_item_t *item ){
+	if( NULL == item->icon ){
+		return;
 	}
 	
-	free(item);	
+	gbitmap_destroy( item->icon );
+	item->icon = NULL;
+	STATUS_BAR_STATS_HEAP_UNTRACK( STATUS_BAR_STATS_HEAP_CATALOG, item->icon_size );
+	
+	if( status_bar_item_is_in_catalog( item ) ){
+		s_status_bar_item_catalog->icon_resident_bytes -= item->icon_size;
+		status_bar_item_set_cached_bit( item );
+	}
+	item->icon_size = 0;
+}
+
+void status_bar_item_destroy( status_bar_item_t *item ){
+	status_bar_item_free_icon( item );
+	
+	if( item->is_static ){							//static items live in app-owned storage, so just hide them
+		item->is_visible = false;
+		item->catalog_index = STATUS_BAR_ITEM_NO_CATALOG_INDEX;
+	} else {
+		STATUS_BAR_FREE(item);
+	}
 }
 
 void status_bar_item_destroy_recursive( status_bar_item_t *item ){
@@ -96,6 +201,10 @@ inline GBitmap *status_bar_item_get_icon( status_bar_item_t *item ){
 	return item->icon;
 }
 
+inline bool status_bar_item_get_visible( status_bar_item_t *item ){
+	return item->is_visible;
+}
+
 inline char *status_bar_item_get_text( status_bar_item_t *item ){
 	return item->text;
 }
@@ -105,74 +214,231 @@ inline status_bar_item_t *status_bar_item_get_next( status_bar_item_t *item ){
 }
 
 
+//recomputes the shown bits of a group from the others, returns true if they changed
+static bool status_bar_item_catalog_update_shown_bits( uint32_t *group_bits ){
+	uint32_t shown = group_bits[STATUS_BAR_ITEM_BITS_LOADED];
+	for( uint8_t i = 0; i < STATUS_BAR_ITEM_BITSET_COUNT - STATUS_BAR_ITEM_BITS_NEEDS_PHONE; i++ ){
+		if( s_status_bar_item_catalog->hiding_bitsets & ( 1 << i ) ){
+			shown &= ~group_bits[STATUS_BAR_ITEM_BITS_NEEDS_PHONE + i];
+		}
+	}
+	
+	bool has_changed = ( shown != group_bits[STATUS_BAR_ITEM_BITS_SHOWN] );
+	if( has_changed ){
+		s_status_bar_item_catalog->shown_count += __builtin_popcount( shown );
+		s_status_bar_item_catalog->shown_count -= __builtin_popcount( group_bits[STATUS_BAR_ITEM_BITS_SHOWN] );
+	}
+	group_bits[STATUS_BAR_ITEM_BITS_SHOWN] = shown;
+	return has_changed;
+}
+
+//recomputes every shown bit, after hiding_bitsets changed (returns true if any changed)
+static bool status_bar_item_catalog_update_all_shown_bits(void){
+	bool has_changed = false;
+	for( size_t i = 0; i < s_status_bar_item_catalog->count; i += STATUS_BAR_ITEM_BITS_PER_GROUP ){
+		has_changed |= status_bar_item_catalog_update_shown_bits( status_bar_item_catalog_get_group_bits( i ) );
+	}
+	return has_changed;
+}
+
+//copies the item's state into its bits, returns true if that changed whether it's shown
+static bool status_bar_item_update_bits( status_bar_item_t *item ){
+	if( NULL == s_status_bar_item_catalog || STATUS_BAR_ITEM_NO_CATALOG_INDEX == item->catalog_index ){
+		return false;
+	}
+	
+	uint32_t *group_bits = status_bar_item_catalog_get_group_bits( item->catalog_index );
+	uint32_t bit = (uint32_t)1 << ( item->catalog_index % STATUS_BAR_ITEM_BITS_PER_GROUP );
+	
+	status_bar_item_set_bit( &( group_bits[STATUS_BAR_ITEM_BITS_LOADED] ), bit, item->is_visible );
+	status_bar_item_set_bit( &( group_bits[STATUS_BAR_ITEM_BITS_CACHED] ), bit, NULL != item->icon );
+	status_bar_item_set_bit( &( group_bits[STATUS_BAR_ITEM_BITS_NEEDS_PHONE] ), bit, item->requires_phone_connection );
+	for( uint8_t i = 0; i < STATUS_BAR_ITEM_APP_FLAG_COUNT; i++ ){
+		status_bar_item_set_bit( &( group_bits[STATUS_BAR_ITEM_BITS_APP_FLAGS + i] ), bit, item->app_flags & ( 1 << i ) );
+	}
+	
+	return status_bar_item_catalog_update_shown_bits( group_bits );
+}
+
+
+//tell the current status bar about changed items (or just remember it, while a batch is open)
+static bool status_bar_item_is_batch_open(void){
+	return ( NULL != s_status_bar_item_catalog ) && ( s_status_bar_item_catalog->batch_depth > 0 );
+}
+
+static void status_bar_item_notify_layout_changed(void){
+	if( status_bar_item_is_batch_open() ){
+		s_status_bar_item_catalog->is_batch_layout_dirty = true;
+		return;
+	}
+	
+	status_bar_window_t *status_bar_window = get_current_status_bar_window();
+	if( NULL != status_bar_window ){
+		status_bar_window_mark_layout_dirty( status_bar_window );
+	}
+}
+
+static void status_bar_item_notify_text_changed( status_bar_item_t *item ){
+	if( status_bar_item_is_batch_open() ){
+		if( NULL == s_status_bar_item_catalog->batch_dirty_item || s_status_bar_item_catalog->batch_dirty_item == item ){
+			s_status_bar_item_catalog->batch_dirty_item = item;		//a single item can still be updated in place
+		} else {
+			s_status_bar_item_catalog->is_batch_layout_dirty = true;
+		}
+		return;
+	}
+	
+	status_bar_window_t *status_bar_window = get_current_status_bar_window();
+	if( NULL != status_bar_window ){
+		status_bar_window_mark_item_dirty( status_bar_window, item );
+	}
+}
+
+
+//evicts least recently used icons, until the icon cache fits its budget (or nothing else can be evicted).
+//candidates are cached icons of items that can't be on screen, found a group of bits at a time
+static void status_bar_item_catalog_trim_icons(void){
+	if( NULL == s_status_bar_item_catalog || 0 == s_status_bar_item_catalog->icon_budget ){
+		return;
+	}
+	
+	while( s_status_bar_item_catalog->icon_resident_bytes > s_status_bar_item_catalog->icon_budget ){
+		status_bar_item_t *oldest = NULL;
+		
+		for( size_t i = 0; i < s_status_bar_item_catalog->count; i += STATUS_BAR_ITEM_BITS_PER_GROUP ){
+			uint32_t *group_bits = status_bar_item_catalog_get_group_bits( i );
+			uint32_t evictable = group_bits[STATUS_BAR_ITEM_BITS_CACHED] & ~group_bits[STATUS_BAR_ITEM_BITS_SHOWN];
+			for( ; 0 != evictable; evictable &= evictable - 1 ){
+				status_bar_item_t *item = status_bar_item_catalog_get_item( i + __builtin_ctz( evictable ) );
+				if( NULL == oldest || item->icon_last_used < oldest->icon_last_used ){
+					oldest = item;
+				}
+			}
+		}
+		
+		if( NULL == oldest ){
+			return;
+		}
+		
+		status_bar_item_free_icon( oldest );
+		s_status_bar_item_catalog->icon_eviction_count++;
+	}
+}
+
+//enforces the icon budget after an update that could break it (once, at commit, while a batch is open)
+static void status_bar_item_catalog_update_icons(void){
+	if( status_bar_item_is_batch_open() ){
+		s_status_bar_item_catalog->is_batch_trim_pending = true;
+		return;
+	}
+	
+	status_bar_item_catalog_trim_icons();
+}
+
+
 //setters
 void status_bar_item_set_text( status_bar_item_t *item, char *text ){
 	// update text
 	item->text = text;
 	
-	// if item is currently shown, mark curent status bar as dirty
-	if( NULL != item->icon ){
-		status_bar_window_t *status_bar_window = get_current_status_bar_window();
-		if( NULL != status_bar_window ){
-			status_bar_window_mark_layout_dirty( status_bar_window );
-		}
+	// if item is currently shown, update it in the current status bar
+	if( item->is_visible ){
+		status_bar_item_notify_text_changed( item );
 	}
 }
 
 
 void status_bar_item_load_new_icon( status_bar_item_t *item, uint32_t icon_resource_id ){
-	if( (item->icon_resource_id == icon_resource_id) && (NULL != item->icon) ){
+	if( (item->icon_resource_id == icon_resource_id) && (NULL == item->icon_atlas) && item->is_visible ){
 		return;										//if icon_resource_id didn't change, and icon was already loaded, do nothing
 	}
 	
-	// update icon_resource_id
+	// update icon_resource_id (no longer using an atlas)
 	item->icon_resource_id = icon_resource_id;
+	item->icon_atlas = NULL;
 	
 	// update icon
-	if( NULL != item->icon ){
-		gbitmap_destroy( item->icon );
-	}
-	item->icon = gbitmap_create_with_resource( icon_resource_id );
+	status_bar_item_free_icon( item );
+	item->is_visible = true;
+	status_bar_item_update_bits( item );
+	status_bar_item_use_icon( item );
+	status_bar_item_catalog_update_icons();
 	
 	
 	// mark curent status bar as dirty
-	status_bar_window_t *status_bar_window = get_current_status_bar_window();
-	if( NULL != status_bar_window ){
-		status_bar_window_mark_layout_dirty( status_bar_window );
-	}
+	status_bar_item_notify_layout_changed();
 }
 
 void status_bar_item_load_icon( status_bar_item_t *item ){
-	if( NULL != item->icon ){						//if icon was already loaded, do nothing
+	if( item->is_visible ){							//if icon was already loaded, do nothing
 		return;
 	}
 	
-	// update icon
-	item->icon = gbitmap_create_with_resource( item->icon_resource_id );
+	// update icon (it might still be in the icon cache)
+	item->is_visible = true;
+	status_bar_item_update_bits( item );
+	status_bar_item_use_icon( item );
+	status_bar_item_catalog_update_icons();
 	
 	
 	// mark curent status bar as dirty
-	status_bar_window_t *status_bar_window = get_current_status_bar_window();
-	if( NULL != status_bar_window ){
-		status_bar_window_mark_layout_dirty( status_bar_window );
-	}
+	status_bar_item_notify_layout_changed();
 }
 
 void status_bar_item_unload_icon( status_bar_item_t *item ){
-	if( NULL == item->icon ){						//if icon was already not loaded, do nothing
+	if( !item->is_visible ){						//if icon was already not loaded, do nothing
 		return;
 	}
 	
-	// update icon
-	gbitmap_destroy( item->icon );
-	item->icon = NULL;
+	// update icon (keep it in the icon cache, if there is one)
+	item->is_visible = false;
+	status_bar_item_update_bits( item );
+	if( NULL == s_status_bar_item_catalog || 0 == s_status_bar_item_catalog->icon_budget ){
+		status_bar_item_free_icon( item );
+	} else {
+		status_bar_item_catalog_update_icons();
+	}
 	
 	
 	// mark curent status bar as dirty
-	status_bar_window_t *status_bar_window = get_current_status_bar_window();
-	if( NULL != status_bar_window ){
-		status_bar_window_mark_layout_dirty( status_bar_window );
+	status_bar_item_notify_layout_changed();
+}
+
+void status_bar_item_set_icon_atlas_slot( status_bar_item_t *item, GBitmap *atlas, GRect slot ){
+	item->icon_atlas = atlas;
+	item->icon_atlas_slot = slot;
+	
+	// if icon was loaded, replace it with the new one
+	if( NULL != item->icon ){
+		status_bar_item_free_icon( item );
+		status_bar_item_alloc_icon( item );
+		
+		status_bar_item_notify_layout_changed();
+	}
+}
+
+
+void status_bar_item_set_app_flags( status_bar_item_t *item, uint8_t app_flags ){
+	item->app_flags = app_flags;
+	
+	// only the current status bar's layout changes, and only if the item was shown or hidden by it
+	if( status_bar_item_update_bits( item ) ){
+		status_bar_item_catalog_update_icons();
+		status_bar_item_notify_layout_changed();
+	}
+}
+
+
+GBitmap *status_bar_item_use_icon( status_bar_item_t *item ){
+	if( NULL == item->icon ){					//reload icon, if it was evicted
+		status_bar_item_alloc_icon( item );
 	}
+	
+	if( NULL != s_status_bar_item_catalog ){		//the budget is enforced after updates, not on every use
+		item->icon_last_used = ++(s_status_bar_item_catalog->icon_uses);
+	}
+	
+	return item->icon;
 }
 
 
@@ -181,20 +447,187 @@ void status_bar_item_unload_icon( status_bar_item_t *item ){
 //-------------------------//
 
 //constructor, destructor
+//shared by both constructors
+static void status_bar_item_catalog_init_common(void){
+	s_status_bar_item_catalog = &s_status_bar_item_catalog_storage;
+	
+	s_status_bar_item_catalog->first = NULL;
+	s_status_bar_item_catalog->last_next_ptr = &(s_status_bar_item_catalog->first);
+	s_status_bar_item_catalog->count = 0;
+	
+	s_status_bar_item_catalog->icon_budget = 0;
+	s_status_bar_item_catalog->icon_resident_bytes = 0;
+	s_status_bar_item_catalog->icon_eviction_count = 0;
+	s_status_bar_item_catalog->icon_uses = 0;
+	
+	s_status_bar_item_catalog->item_bits = NULL;
+	s_status_bar_item_catalog->item_capacity = 0;
+	s_status_bar_item_catalog->item_table = NULL;
+	s_status_bar_item_catalog->static_items = NULL;
+	s_status_bar_item_catalog->hiding_bitsets = 0;
+	s_status_bar_item_catalog->shown_count = 0;
+	status_bar_item_catalog_set_is_connected_to_phone( connection_service_peek_pebble_app_connection() );
+	
+	s_status_bar_item_catalog->id_index = NULL;
+	s_status_bar_item_catalog->id_index_capacity = 0;
+	s_status_bar_item_catalog->id_index_count = 0;
+	
+	s_status_bar_item_catalog->batch_depth = 0;
+	s_status_bar_item_catalog->is_batch_layout_dirty = false;
+	s_status_bar_item_catalog->is_batch_trim_pending = false;
+	s_status_bar_item_catalog->batch_dirty_item = NULL;
+}
+
+
+//id index (multiplicative hashing, then linear probing)
+static size_t status_bar_item_catalog_index_hash( uint32_t item_id ){
+	uint32_t hash = item_id * 2654435761u;
+	hash ^= hash >> 16;								//so ids that only differ in their high bits don't collide
+	return hash & ( s_status_bar_item_catalog->id_index_capacity - 1 );
+}
+
+//returns the slot holding the item with the given id, or the empty slot where it would go (NULL if index has no room)
+static status_bar_item_t **status_bar_item_catalog_index_find_slot( uint32_t item_id ){
+	size_t mask = s_status_bar_item_catalog->id_index_capacity - 1;
+	size_t i = status_bar_item_catalog_index_hash( item_id );
+	
+	for( size_t probes = 0; probes < s_status_bar_item_catalog->id_index_capacity; probes++ ){
+		status_bar_item_t **slot = &( s_status_bar_item_catalog->id_index[i] );
+		if( NULL == *slot || (*slot)->id == item_id ){
+			return slot;
+		}
+		i = ( i + 1 ) & mask;
+	}
+	
+	return NULL;
+}
+
+//moves every indexed item to a new table with the given capacity (keeps the old one if allocation fails)
+static void status_bar_item_catalog_index_resize( size_t capacity ){
+	status_bar_item_t **old_index = s_status_bar_item_catalog->id_index;
+	size_t old_capacity = s_status_bar_item_catalog->id_index_capacity;
+	
+	status_bar_item_t **new_index = STATUS_BAR_CALLOC( STATUS_BAR_STATS_HEAP_CATALOG, capacity, sizeof(*new_index) );
+	if( NULL == new_index ){
+		return;
+	}
+	
+	s_status_bar_item_catalog->id_index = new_index;
+	s_status_bar_item_catalog->id_index_capacity = capacity;
+	
+	for( size_t i = 0; i < old_capacity; i++ ){
+		if( NULL != old_index[i] ){
+			*status_bar_item_catalog_index_find_slot( old_index[i]->id ) = old_index[i];
+		}
+	}
+	
+	STATUS_BAR_FREE( old_index );
+}
+
+static void status_bar_item_catalog_index_insert( status_bar_item_t *item ){
+	if( 2 * ( s_status_bar_item_catalog->id_index_count + 1 ) > s_status_bar_item_catalog->id_index_capacity ){
+		status_bar_item_catalog_index_resize(
+			( 0 == s_status_bar_item_catalog->id_index_capacity ) ?
+				STATUS_BAR_ITEM_INDEX_MIN_CAPACITY : 2 * s_status_bar_item_catalog->id_index_capacity
+		);
+	}
+	
+	status_bar_item_t **slot = status_bar_item_catalog_index_find_slot( item->id );
+	if( NULL == slot ){								//index is full, and couldn't grow
+		return;
+	}
+	
+	if( NULL == *slot ){
+		s_status_bar_item_catalog->id_index_count++;
+	}
+	*slot = item;									//an item with the same id replaces the previous one
+}
+
+//grows item_table and item_bits to hold at least item_count items (keeps the old ones if allocation fails)
+static void status_bar_item_catalog_items_resize( size_t item_count ){
+	size_t capacity = STATUS_BAR_ITEM_BITS_PER_GROUP;
+	while( capacity < item_count ){
+		capacity *= 2;
+	}
+	if( capacity > STATUS_BAR_ITEM_NO_CATALOG_INDEX ){
+		return;
+	}
+	
+	status_bar_item_t **new_table = STATUS_BAR_CALLOC( STATUS_BAR_STATS_HEAP_CATALOG, capacity, sizeof(*new_table) );
+	uint32_t *new_bits = STATUS_BAR_CALLOC( STATUS_BAR_STATS_HEAP_CATALOG, STATUS_BAR_ITEM_BITSET_WORDS( capacity ), sizeof(*new_bits) );
+	if( NULL == new_table || NULL == new_bits ){
+		STATUS_BAR_FREE( new_table );
+		STATUS_BAR_FREE( new_bits );
+		return;
+	}
+	
+	//groups are laid out one after the other, so existing ones keep their place
+	if( s_status_bar_item_catalog->item_capacity > 0 ){
+		memcpy( new_table, s_status_bar_item_catalog->item_table, s_status_bar_item_catalog->item_capacity * sizeof(*new_table) );
+		memcpy(
+			new_bits, s_status_bar_item_catalog->item_bits,
+			STATUS_BAR_ITEM_BITSET_WORDS( s_status_bar_item_catalog->item_capacity ) * sizeof(*new_bits)
+		);
+	}
+	
+	STATUS_BAR_FREE( s_status_bar_item_catalog->item_table );
+	STATUS_BAR_FREE( s_status_bar_item_catalog->item_bits );
+	s_status_bar_item_catalog->item_table = new_table;
+	s_status_bar_item_catalog->item_bits = new_bits;
+	s_status_bar_item_catalog->item_capacity = capacity;
+}
+
 void status_bar_item_catalog_init( size_t item_id_count ){
 	if( NULL != s_status_bar_item_catalog ){			//if catalog has already been initialized, do nothing
 		return;
 	}
 	
-	s_status_bar_item_catalog = malloc( sizeof(*s_status_bar_item_catalog) );
+	status_bar_item_catalog_init_common();
 	
-	s_status_bar_item_catalog->first = NULL;
-	s_status_bar_item_catalog->last_next_ptr = &(s_status_bar_item_catalog->first);
+	//apps pass their id range, which can be far more than the items they insert (sparse ids),
+	//so it only presizes up to a few items, and the index and item tables grow on insert
+	size_t item_count = ( item_id_count < STATUS_BAR_ITEM_CATALOG_INIT_MAX_ITEMS ) ? item_id_count : STATUS_BAR_ITEM_CATALOG_INIT_MAX_ITEMS;
 	
-	s_status_bar_item_catalog->id_table = calloc(		//array with item_id_max elements, all initially NULL
-		item_id_count,
-		sizeof( *(s_status_bar_item_catalog->id_table) )
-	);
+	//room for item_count items, without going over half full
+	size_t capacity = STATUS_BAR_ITEM_INDEX_MIN_CAPACITY;
+	while( capacity < 2 * item_count ){
+		capacity *= 2;
+	}
+	status_bar_item_catalog_index_resize( capacity );
+	status_bar_item_catalog_items_resize( item_count );
+	
+	s_status_bar_item_catalog->id_table = NULL;
+	s_status_bar_item_catalog->id_count = 0;
+	s_status_bar_item_catalog->is_static = false;
+}
+
+void status_bar_item_catalog_init_static(
+	status_bar_item_t *items,
+	size_t item_count,
+	status_bar_item_t * const *id_table,
+	size_t item_id_count,
+	uint32_t *item_bits
+){
+	if( NULL != s_status_bar_item_catalog ){			//if catalog has already been initialized, do nothing
+		return;
+	}
+	
+	status_bar_item_catalog_init_common();
+	
+	s_status_bar_item_catalog->id_table = id_table;
+	s_status_bar_item_catalog->id_count = item_id_count;
+	s_status_bar_item_catalog->is_static = true;
+	
+	//bitsets are static data too, sized for the declared items
+	memset( item_bits, 0, STATUS_BAR_ITEM_BITSET_WORDS( item_count ) * sizeof(*item_bits) );
+	s_status_bar_item_catalog->item_bits = item_bits;
+	s_status_bar_item_catalog->item_capacity = item_count;
+	s_status_bar_item_catalog->static_items = items;
+	
+	//priority is the declaration order
+	for( size_t i = 0; i < item_count; i++ ){
+		status_bar_item_catalog_insert( &(items[i]) );
+	}
 }
 
 void status_bar_item_catalog_deinit(void){
@@ -204,8 +637,18 @@ void status_bar_item_catalog_deinit(void){
 	
 	status_bar_item_destroy_recursive( s_status_bar_item_catalog->first );
 	
-	free( s_status_bar_item_catalog->id_table );
-	free( s_status_bar_item_catalog );
+	STATUS_BAR_FREE( s_status_bar_item_catalog->id_index );
+	s_status_bar_item_catalog->id_index = NULL;
+	s_status_bar_item_catalog->id_table = NULL;
+	
+	if( !s_status_bar_item_catalog->is_static ){
+		STATUS_BAR_FREE( s_status_bar_item_catalog->item_table );
+		STATUS_BAR_FREE( s_status_bar_item_catalog->item_bits );
+	}
+	s_status_bar_item_catalog->item_table = NULL;
+	s_status_bar_item_catalog->item_bits = NULL;
+	s_status_bar_item_catalog->static_items = NULL;
+	s_status_bar_item_catalog = NULL;
 }
 
 
@@ -213,8 +656,13 @@ void status_bar_item_catalog_deinit(void){
 status_bar_item_t *status_bar_item_catalog_find( uint32_t item_id ){
 	if( NULL == s_status_bar_item_catalog ){			//if catalog has not been initialized, return nothing
 		return NULL;
+		
+	} else if( s_status_bar_item_catalog->is_static ){
+		return ( item_id < s_status_bar_item_catalog->id_count ) ? s_status_bar_item_catalog->id_table[item_id] : NULL;
+		
 	} else {
-		return s_status_bar_item_catalog->id_table[item_id];
+		status_bar_item_t **slot = status_bar_item_catalog_index_find_slot( item_id );
+		return ( NULL == slot ) ? NULL : *slot;
 	}
 }
 
@@ -222,6 +670,52 @@ inline status_bar_item_t *status_bar_item_catalog_get_first(void){
 	return s_status_bar_item_catalog->first;
 }
 
+//first shown item at or after catalog_index, found a group of bits at a time
+static status_bar_item_t *status_bar_item_catalog_find_shown( size_t catalog_index ){
+	if( NULL == s_status_bar_item_catalog ){
+		return NULL;
+	}
+	
+	for( ; catalog_index < s_status_bar_item_catalog->count; catalog_index += STATUS_BAR_ITEM_BITS_PER_GROUP ){
+		size_t offset = catalog_index % STATUS_BAR_ITEM_BITS_PER_GROUP;
+		uint32_t shown = status_bar_item_catalog_get_group_bits( catalog_index )[STATUS_BAR_ITEM_BITS_SHOWN] >> offset;
+		if( 0 != shown ){
+			return status_bar_item_catalog_get_item( catalog_index + __builtin_ctz( shown ) );
+		}
+		catalog_index -= offset;
+	}
+	
+	return NULL;
+}
+
+status_bar_item_t *status_bar_item_catalog_get_first_shown(void){
+	return status_bar_item_catalog_find_shown( 0 );
+}
+
+status_bar_item_t *status_bar_item_catalog_get_next_shown( status_bar_item_t *item ){
+	return status_bar_item_catalog_find_shown( item->catalog_index + 1 );
+}
+
+size_t status_bar_item_catalog_get_count(void){
+	if( NULL == s_status_bar_item_catalog ){			//if catalog has not been initialized, it has no items
+		return 0;
+	} else {
+		return s_status_bar_item_catalog->count;
+	}
+}
+
+size_t status_bar_item_catalog_get_shown_count(void){
+	return ( NULL == s_status_bar_item_catalog ) ? 0 : s_status_bar_item_catalog->shown_count;
+}
+
+size_t status_bar_item_catalog_get_icon_resident_bytes(void){
+	return ( NULL == s_status_bar_item_catalog ) ? 0 : s_status_bar_item_catalog->icon_resident_bytes;
+}
+
+uint32_t status_bar_item_catalog_get_icon_eviction_count(void){
+	return ( NULL == s_status_bar_item_catalog ) ? 0 : s_status_bar_item_catalog->icon_eviction_count;
+}
+
 
 //setters
 void status_bar_item_catalog_insert( status_bar_item_t *item ){
@@ -230,12 +724,101 @@ void status_bar_item_catalog_insert( status_bar_item_t *item ){
 		return;
 	}
 	
+	//give item its bits (static catalogs have room for their declared items only)
+	if( s_status_bar_item_catalog->count >= s_status_bar_item_catalog->item_capacity && !s_status_bar_item_catalog->is_static ){
+		status_bar_item_catalog_items_resize( s_status_bar_item_catalog->count + 1 );
+	}
+	if( s_status_bar_item_catalog->count >= s_status_bar_item_catalog->item_capacity ){
+		status_bar_item_destroy( item );
+		return;
+	}
+	
+	item->catalog_index = s_status_bar_item_catalog->count;
+	if( !s_status_bar_item_catalog->is_static ){
+		s_status_bar_item_catalog->item_table[item->catalog_index] = item;
+	}
+	status_bar_item_update_bits( item );
+	
 	//add item to END of catalog (lower priority than previous last)
 	*(s_status_bar_item_catalog->last_next_ptr) = item;
 	s_status_bar_item_catalog->last_next_ptr = &(item->next);
+	s_status_bar_item_catalog->count++;
 	
-	//also point to item from id_table
-	s_status_bar_item_catalog->id_table[item->id] = item;
+	//also index item by id (a static id_table already does)
+	if( !s_status_bar_item_catalog->is_static ){
+		status_bar_item_catalog_index_insert( item );
+	}
+	
+	//icon might have been loaded before insertion
+	s_status_bar_item_catalog->icon_resident_bytes += item->icon_size;
+	status_bar_item_catalog_update_icons();
+}
+
+void status_bar_item_catalog_set_icon_budget( size_t icon_budget ){
+	if( NULL != s_status_bar_item_catalog ){
+		s_status_bar_item_catalog->icon_budget = icon_budget;
+		status_bar_item_catalog_trim_icons();
+	}
+}
+
+//both only recompute the shown bits, a group of items at a time
+void status_bar_item_catalog_set_is_connected_to_phone( bool connected ){
+	if( NULL == s_status_bar_item_catalog ){
+		return;
+	}
+	
+	s_status_bar_item_catalog->hiding_bitsets = connected ?
+		( s_status_bar_item_catalog->hiding_bitsets & ~1 ) : ( s_status_bar_item_catalog->hiding_bitsets | 1 );
+	if( status_bar_item_catalog_update_all_shown_bits() ){
+		status_bar_item_catalog_update_icons();
+	}
+}
+
+void status_bar_item_catalog_set_hidden_app_flags( uint8_t app_flags ){
+	if( NULL == s_status_bar_item_catalog ){
+		return;
+	}
+	
+	app_flags &= ( 1 << STATUS_BAR_ITEM_APP_FLAG_COUNT ) - 1;
+	s_status_bar_item_catalog->hiding_bitsets = ( s_status_bar_item_catalog->hiding_bitsets & 1 ) | ( app_flags << 1 );
+	if( status_bar_item_catalog_update_all_shown_bits() ){
+		status_bar_item_catalog_update_icons();
+		status_bar_item_notify_layout_changed();
+	}
 }
 
-	
\ No newline at end of file
+	
+
+//batches
+void status_bar_item_catalog_begin_update(void){
+	if( NULL != s_status_bar_item_catalog ){
+		s_status_bar_item_catalog->batch_depth++;
+	}
+}
+
+void status_bar_item_catalog_commit_update(void){
+	if( NULL == s_status_bar_item_catalog || 0 == s_status_bar_item_catalog->batch_depth ){
+		return;
+	}
+	
+	s_status_bar_item_catalog->batch_depth--;
+	if( s_status_bar_item_catalog->batch_depth > 0 ){	//only the outermost batch updates the status bar
+		return;
+	}
+	
+	bool is_layout_dirty = s_status_bar_item_catalog->is_batch_layout_dirty;
+	status_bar_item_t *dirty_item = s_status_bar_item_catalog->batch_dirty_item;
+	s_status_bar_item_catalog->is_batch_layout_dirty = false;
+	s_status_bar_item_catalog->batch_dirty_item = NULL;
+	
+	if( s_status_bar_item_catalog->is_batch_trim_pending ){
+		s_status_bar_item_catalog->is_batch_trim_pending = false;
+		status_bar_item_catalog_trim_icons();
+	}
+	
+	if( is_layout_dirty ){
+		status_bar_item_notify_layout_changed();
+	} else if( NULL != dirty_item ){
+		status_bar_item_notify_text_changed( dirty_item );
+	}
+}
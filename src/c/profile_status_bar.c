@@ -0,0 +1,111 @@
+#include <pebble.h>
+#include "include/profile_status_bar.h"
+
+
+//-------------//
+// Static vars //
+//-------------//
+
+static status_bar_profile_histogram_t s_status_bar_profile_histograms[STATUS_BAR_PROFILE_POINT_COUNT];
+
+static uint32_t s_status_bar_profile_log_interval_ms = 0;
+static AppTimer *s_status_bar_profile_log_timer = NULL;
+
+static const char *s_status_bar_profile_point_names[STATUS_BAR_PROFILE_POINT_COUNT] = {
+	[STATUS_BAR_PROFILE_POINT_BUILD_LAYOUT] = "build_layout",
+	[STATUS_BAR_PROFILE_POINT_TICK_HANDLER] = "tick_handler",
+	[STATUS_BAR_PROFILE_POINT_BATTERY_HANDLER] = "battery_handler",
+	[STATUS_BAR_PROFILE_POINT_CONNECTION_HANDLER] = "connection_handler",
+	[STATUS_BAR_PROFILE_POINT_RENDER_TIME] = "render time",
+	[STATUS_BAR_PROFILE_POINT_RENDER_TIME_SUFFIX] = "render time suffix",
+	[STATUS_BAR_PROFILE_POINT_RENDER_BATTERY_ICON] = "render battery icon",
+	[STATUS_BAR_PROFILE_POINT_RENDER_PHONE_ICON] = "render phone icon",
+	[STATUS_BAR_PROFILE_POINT_RENDER_BATTERY_TEXT] = "render battery text",
+	[STATUS_BAR_PROFILE_POINT_RENDER_CATALOG_ITEM] = "render catalog item"
+};
+
+
+//-----------//
+// Profiling //
+//-----------//
+
+//getters
+const status_bar_profile_histogram_t *status_bar_profile_get_histogram( status_bar_profile_point_t point ){
+	return ( point < STATUS_BAR_PROFILE_POINT_COUNT ) ? &(s_status_bar_profile_histograms[point]) : NULL;
+}
+
+
+//setters
+void status_bar_profile_reset(void){
+	memset( s_status_bar_profile_histograms, 0, sizeof(s_status_bar_profile_histograms) );
+}
+
+void status_bar_profile_record( status_bar_profile_point_t point, uint32_t elapsed ){
+	if( point >= STATUS_BAR_PROFILE_POINT_COUNT ){		//unknown point, do nothing
+		return;
+	}
+	
+	status_bar_profile_histogram_t *histogram = &(s_status_bar_profile_histograms[point]);
+	histogram->count++;
+	histogram->total += elapsed;
+	if( elapsed > histogram->max ){
+		histogram->max = elapsed;
+	}
+	
+	//bucket is the number of significant bits of elapsed (so each bucket is twice as wide as the previous one)
+	int bucket = 0;
+	while( elapsed > 0 && bucket < STATUS_BAR_PROFILE_HISTOGRAM_BUCKETS - 1 ){
+		elapsed >>= 1;
+		bucket++;
+	}
+	histogram->buckets[bucket]++;
+}
+
+
+//logging
+void status_bar_profile_log(void){
+	for( int point = 0; point < STATUS_BAR_PROFILE_POINT_COUNT; point++ ){
+		status_bar_profile_histogram_t *histogram = &(s_status_bar_profile_histograms[point]);
+		if( 0 == histogram->count ){
+			continue;
+		}
+		
+		//bucket counts, separated by spaces
+		char buckets_text[STATUS_BAR_PROFILE_HISTOGRAM_BUCKETS * 11 + 1] = "";
+		size_t length = 0;
+		for( int bucket = 0; bucket < STATUS_BAR_PROFILE_HISTOGRAM_BUCKETS; bucket++ ){
+			length += snprintf(
+				buckets_text + length, sizeof(buckets_text) - length, " %lu", (unsigned long)histogram->buckets[bucket]
+			);
+		}
+		
+		APP_LOG(
+			APP_LOG_LEVEL_DEBUG, "status bar profile %s: %lu samples, %lu avg, %lu max, histogram%s",
+			s_status_bar_profile_point_names[point],
+			(unsigned long)histogram->count,
+			(unsigned long)( histogram->total / histogram->count ),
+			(unsigned long)histogram->max,
+			buckets_text
+		);
+	}
+}
+
+static void status_bar_profile_log_timer_callback( void *data ){
+	(void)data;
+	status_bar_profile_log();
+	s_status_bar_profile_log_timer = app_timer_register(
+		s_status_bar_profile_log_interval_ms, status_bar_profile_log_timer_callback, NULL
+	);
+}
+
+void status_bar_profile_set_log_interval( uint32_t interval_ms ){
+	if( NULL != s_status_bar_profile_log_timer ){
+		app_timer_cancel( s_status_bar_profile_log_timer );
+		s_status_bar_profile_log_timer = NULL;
+	}
+	
+	s_status_bar_profile_log_interval_ms = interval_ms;
+	if( interval_ms > 0 ){
+		s_status_bar_profile_log_timer = app_timer_register( interval_ms, status_bar_profile_log_timer_callback, NULL );
+	}
+}
@@ -0,0 +1,207 @@
+#include <pebble.h>
+#include "include/stats_status_bar.h"
+
+
+//-------------//
+// Static vars //
+//-------------//
+
+static status_bar_stats_t s_status_bar_stats;
+
+static const char *s_status_bar_stats_event_names[STATUS_BAR_STATS_EVENT_COUNT] = {
+	[STATUS_BAR_STATS_EVENT_BUILD_LAYOUT] = "build_layout",
+	[STATUS_BAR_STATS_EVENT_RENDER] = "render",
+	[STATUS_BAR_STATS_EVENT_TICK] = "tick",
+	[STATUS_BAR_STATS_EVENT_BATTERY] = "battery",
+	[STATUS_BAR_STATS_EVENT_CONNECTION] = "connection"
+};
+
+static const char *s_status_bar_stats_heap_names[STATUS_BAR_STATS_HEAP_COUNT] = {
+	[STATUS_BAR_STATS_HEAP_CATALOG] = "catalog",
+	[STATUS_BAR_STATS_HEAP_LAYOUT] = "layout",
+	[STATUS_BAR_STATS_HEAP_RESOURCES] = "resources",
+	[STATUS_BAR_STATS_HEAP_WINDOW] = "window"
+};
+
+static const char *s_status_bar_stats_counter_names[STATUS_BAR_STATS_COUNTER_COUNT] = {
+	[STATUS_BAR_STATS_COUNTER_TEXT_CACHE_HIT] = "text cache hits",
+	[STATUS_BAR_STATS_COUNTER_TEXT_CACHE_MISS] = "text cache misses",
+	[STATUS_BAR_STATS_COUNTER_GLYPH_TABLE_HIT] = "glyph table measurements",
+	[STATUS_BAR_STATS_COUNTER_SUPPRESSED_TICK] = "suppressed ticks",
+	[STATUS_BAR_STATS_COUNTER_SUPPRESSED_BATTERY] = "suppressed battery events",
+	[STATUS_BAR_STATS_COUNTER_SUPPRESSED_PHONE_BATTERY] = "suppressed phone battery updates",
+	[STATUS_BAR_STATS_COUNTER_COALESCED_PHONE_BATTERY] = "coalesced phone battery updates"
+};
+
+
+//------------//
+// Data Types //
+//------------//
+
+//prefix of every accounted allocation (a union, so the allocation itself stays aligned)
+typedef union status_bar_stats_alloc_header_u {
+	struct {
+		uint32_t size;
+		uint8_t heap;
+	} info;
+	uint64_t align;
+} status_bar_stats_alloc_header_t;
+
+
+//------------//
+// Statistics //
+//------------//
+
+//getters
+const status_bar_stats_t *status_bar_stats_get(void){
+	return &s_status_bar_stats;
+}
+
+uint32_t status_bar_stats_get_time_ms(void){
+	time_t seconds;
+	uint16_t milliseconds;
+	time_ms( &seconds, &milliseconds );
+	
+	return (uint32_t)seconds * 1000 + milliseconds;
+}
+
+
+//setters
+void status_bar_stats_reset(void){
+	memset( &s_status_bar_stats, 0, sizeof(s_status_bar_stats) );
+}
+
+void status_bar_stats_record_event( status_bar_stats_event_t event, uint32_t elapsed_ms ){
+	if( event >= STATUS_BAR_STATS_EVENT_COUNT ){		//unknown event, do nothing
+		return;
+	}
+	
+	status_bar_stats_timing_t *timing = &(s_status_bar_stats.events[event]);
+	timing->count++;
+	timing->total_ms += elapsed_ms;
+	if( elapsed_ms > timing->max_ms ){
+		timing->max_ms = elapsed_ms;
+	}
+}
+
+void status_bar_stats_increment( status_bar_stats_counter_t counter ){
+	if( counter < STATUS_BAR_STATS_COUNTER_COUNT ){
+		s_status_bar_stats.counters[counter]++;
+	}
+}
+
+
+//logging
+void status_bar_stats_log(void){
+	for( int event = 0; event < STATUS_BAR_STATS_EVENT_COUNT; event++ ){
+		status_bar_stats_timing_t *timing = &(s_status_bar_stats.events[event]);
+		
+		APP_LOG(
+			APP_LOG_LEVEL_DEBUG, "status bar %s: %lu events, %lu ms avg, %lu ms max",
+			s_status_bar_stats_event_names[event],
+			(unsigned long)timing->count,
+			(unsigned long)( ( timing->count > 0 ) ? timing->total_ms / timing->count : 0 ),
+			(unsigned long)timing->max_ms
+		);
+	}
+	
+	for( int counter = 0; counter < STATUS_BAR_STATS_COUNTER_COUNT; counter++ ){
+		APP_LOG(
+			APP_LOG_LEVEL_DEBUG, "status bar %s: %lu",
+			s_status_bar_stats_counter_names[counter],
+			(unsigned long)s_status_bar_stats.counters[counter]
+		);
+	}
+	
+	status_bar_stats_log_heap();
+}
+
+static void status_bar_stats_log_heap_usage( const char *name, status_bar_stats_heap_usage_t *usage ){
+	APP_LOG(
+		APP_LOG_LEVEL_DEBUG, "status bar heap %s: %lu bytes, %lu bytes peak, %lu allocs, %lu frees",
+		name,
+		(unsigned long)usage->current_bytes,
+		(unsigned long)usage->peak_bytes,
+		(unsigned long)usage->alloc_count,
+		(unsigned long)usage->free_count
+	);
+}
+
+void status_bar_stats_log_heap(void){
+	for( int heap = 0; heap < STATUS_BAR_STATS_HEAP_COUNT; heap++ ){
+		status_bar_stats_log_heap_usage( s_status_bar_stats_heap_names[heap], &(s_status_bar_stats.heaps[heap]) );
+	}
+	status_bar_stats_log_heap_usage( "total", &(s_status_bar_stats.heap_total) );
+}
+
+
+//heap accounting
+static void status_bar_stats_heap_usage_add( status_bar_stats_heap_usage_t *usage, size_t bytes ){
+	usage->alloc_count++;
+	usage->current_bytes += bytes;
+	if( usage->current_bytes > usage->peak_bytes ){
+		usage->peak_bytes = usage->current_bytes;
+	}
+}
+
+static void status_bar_stats_heap_usage_remove( status_bar_stats_heap_usage_t *usage, size_t bytes ){
+	usage->free_count++;
+	usage->current_bytes -= bytes;
+}
+
+void status_bar_stats_heap_track( status_bar_stats_heap_t heap, size_t bytes ){
+	if( heap < STATUS_BAR_STATS_HEAP_COUNT ){
+		status_bar_stats_heap_usage_add( &(s_status_bar_stats.heaps[heap]), bytes );
+		status_bar_stats_heap_usage_add( &(s_status_bar_stats.heap_total), bytes );
+	}
+}
+
+void status_bar_stats_heap_untrack( status_bar_stats_heap_t heap, size_t bytes ){
+	if( heap < STATUS_BAR_STATS_HEAP_COUNT ){
+		status_bar_stats_heap_usage_remove( &(s_status_bar_stats.heaps[heap]), bytes );
+		status_bar_stats_heap_usage_remove( &(s_status_bar_stats.heap_total), bytes );
+	}
+}
+
+size_t status_bar_stats_get_bitmap_bytes( GBitmap *bitmap ){
+	if( NULL == bitmap ){
+		return 0;
+	}
+	
+	return gbitmap_get_bytes_per_row( bitmap ) * gbitmap_get_bounds( bitmap ).size.h;
+}
+
+
+//accounted allocations
+void *status_bar_stats_malloc( status_bar_stats_heap_t heap, size_t size ){
+	status_bar_stats_alloc_header_t *header = malloc( sizeof(*header) + size );
+	if( NULL == header ){
+		return NULL;
+	}
+	
+	header->info.size = size;
+	header->info.heap = heap;
+	status_bar_stats_heap_track( heap, size );
+	
+	return header + 1;
+}
+
+void *status_bar_stats_calloc( status_bar_stats_heap_t heap, size_t count, size_t size ){
+	void *ptr = status_bar_stats_malloc( heap, count * size );
+	if( NULL != ptr ){
+		memset( ptr, 0, count * size );
+	}
+	
+	return ptr;
+}
+
+void status_bar_stats_free( void *ptr ){
+	if( NULL == ptr ){
+		return;
+	}
+	
+	status_bar_stats_alloc_header_t *header = (status_bar_stats_alloc_header_t *)ptr - 1;
+	status_bar_stats_heap_untrack( header->info.heap, header->info.size );
+	
+	free( header );
+}
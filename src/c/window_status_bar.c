@@ -1,43 +1,177 @@
 #include <pebble.h>
 #include "include/core_status_bar.h"
 #include "include/window_status_bar.h"
+#include "include/stats_status_bar.h"
+#include "include/profile_status_bar.h"
 
 
 //------------//
 // Data Types //
 //------------//
 
+//what a battery icon looks like, for a given charge state
+typedef enum {
+	STATUS_BAR_BATTERY_GLYPH_FILL,				//not charging: charged area is filled
+	STATUS_BAR_BATTERY_GLYPH_CHARGING_EMPTY,
+	STATUS_BAR_BATTERY_GLYPH_CHARGING_FULL,
+	STATUS_BAR_BATTERY_GLYPH_CHARGING_HALF
+} status_bar_window_battery_glyph_t;
+
+typedef struct status_bar_window_battery_visual_s {
+	status_bar_window_battery_glyph_t glyph;
+	int8_t missing_height;						//height of the empty area above the fill (only for STATUS_BAR_BATTERY_GLYPH_FILL)
+} status_bar_window_battery_visual_t;
+
+
+//display list commands, compiled from the layout items and replayed by the status bar layer
+typedef enum {
+	STATUS_BAR_WINDOW_DRAW_BITMAP,				//bitmap, with STATUS_BAR_COMP_OP_NORMAL
+	STATUS_BAR_WINDOW_DRAW_BITMAP_INVERTED,		//bitmap, with STATUS_BAR_COMP_OP_INVERTED
+	STATUS_BAR_WINDOW_DRAW_FILL,				//rectangle filled with the foreground color
+	STATUS_BAR_WINDOW_DRAW_TEXT					//text in the foreground color
+} status_bar_window_draw_type_t;
+
+typedef struct status_bar_window_draw_command_s {
+	uint8_t type;					//status_bar_window_draw_type_t
+	uint8_t alignment;				//GTextAlignment (only for texts)
+	#ifdef STATUS_BAR_ENABLE_PROFILING
+		uint8_t profile_point;		//status_bar_profile_point_t of the item the command was compiled from
+	#endif
+	GRect rect;						//in status bar coordinates
+	
+	GBitmap *bitmap;				//only for bitmaps
+	char *text;						//only for texts
+	GFont text_font;
+} status_bar_window_draw_command_t;
+
+
 //status bar window layouts and layout-items
-struct status_bar_window_layout_item_s {
-	GTextAlignment alignment;
-	status_bar_border_distance_t distance;
+//(layout items only keep what the fit and render loops need, battery parameters are kept apart since most items don't use them)
+typedef struct status_bar_window_layout_battery_s {
+	BatteryChargeState *state;
+	int full_missing_percent;
+	int empty_missing_percent;
 	
-	status_bar_window_layout_item_parts_t parts;
+	GRect area;						//where the charge is drawn (relative to the icon)
 	
+	status_bar_window_battery_visual_t visual;		//for the current charge state, updated when the item is placed
+} status_bar_window_layout_battery_t;
+
+struct status_bar_window_layout_item_s {
+	uint8_t alignment;				//GTextAlignment
+	uint8_t distance;				//status_bar_border_distance_t
+	int8_t distance_offset;
 	uint8_t width;
-	status_bar_window_layout_item_t *next;
+	GSize text_size;
+	bool is_text_size_fixed;
+	
+	char *text;
+	GFont text_font;
+	GBitmap *icon;
+	
+	//where icon and text go, in status bar coordinates (updated when the item is placed)
+	int16_t icon_x;
+	int16_t text_x;
+	
+	status_bar_window_layout_battery_t *battery;		//NULL for all but battery icons
+	status_bar_item_t *source;		//catalog item this layout item was built from (NULL for system items)
+	uint16_t rank;					//position among its zone's items at its distance, in the order they were added
 };
 
 struct status_bar_window_layout_s {
+	//items in the order they were added, reset (instead of freed item by item) whenever the layout is rebuilt,
+	//and then sorted in place into render order: each zone's items are contiguous, from the screen border inwards
+	//(center ones from the left)
+	status_bar_window_layout_item_t *items;
+	size_t item_capacity;
+	size_t item_count;
+	uint16_t zone_start[STATUS_BAR_WINDOW_ZONE_COUNT];
+	uint16_t zone_count[STATUS_BAR_WINDOW_ZONE_COUNT];
+	
+	//how many items each zone has at each distance (so they can be put in render order in O(N) time)
+	uint16_t bucket_count[STATUS_BAR_WINDOW_ZONE_COUNT][STATUS_BAR_BORDER_DISTANCE_COUNT];
+	
+	status_bar_window_layout_battery_t batteries[STATUS_BAR_LAYOUT_BATTERY_CAPACITY];
+	size_t battery_count;
+	
 	uint8_t left_width;
 	uint8_t center_width;
 	uint8_t right_width;
 	
-	status_bar_border_distance_t left_max_distance;
-	status_bar_border_distance_t center_max_distance;
-	status_bar_border_distance_t right_max_distance;	
+	//system items, so they can be updated in place (NULL if not part of the layout)
+	status_bar_window_layout_item_t *system_items[STATUS_BAR_WINDOW_SYSTEM_ITEM_COUNT];
 	
-	status_bar_window_layout_item_t *left_first;		//leftmost
-	status_bar_window_layout_item_t **left_last_next_ptr;
-		
-	status_bar_window_layout_item_t *center_first;		//leftmost
-	status_bar_window_layout_item_t **center_last_next_ptr;
+	//whether any item was left out for not fitting (it might fit later, if some other item shrinks)
+	bool has_rejected_items;
 	
-	status_bar_window_layout_item_t *right_first;	//rightmost
-	status_bar_window_layout_item_t **right_last_next_ptr;
+	//display list: each zone's commands are contiguous, in draw order (compiled again only after items change)
+	status_bar_window_draw_command_t *commands;
+	size_t command_capacity;			//grown when compiling, if items need more commands
+	uint16_t command_start[STATUS_BAR_WINDOW_ZONE_COUNT];
+	uint16_t command_count[STATUS_BAR_WINDOW_ZONE_COUNT];
+	bool is_display_list_valid;
 };
 
 
+//bitmaps shared between all windows, cut from a single atlas on first use
+typedef enum {
+	STATUS_BAR_WINDOW_RESOURCE_ICON_PHONE,
+	STATUS_BAR_WINDOW_RESOURCE_ICON_BATTERY,
+	STATUS_BAR_WINDOW_RESOURCE_ICON_CHARGING,
+	STATUS_BAR_WINDOW_RESOURCE_ICON_CHARGING_HALF,
+	
+	STATUS_BAR_WINDOW_RESOURCE_COUNT
+} status_bar_window_resource_t;
+
+typedef struct status_bar_window_resources_s {
+	GBitmap *atlas;												//NULL until first used
+	GBitmap *bitmaps[STATUS_BAR_WINDOW_RESOURCE_COUNT];		//sub-bitmaps of atlas, NULL until first used
+	
+	size_t ref_count;				//number of windows using these resources
+	uint32_t keep_alive_ms;
+	AppTimer *release_timer;		//pending release, once ref_count dropped to zero
+} status_bar_window_resources_t;
+
+
+//phone's charge state, as last sent by the phone (kept between windows, like the shared resources)
+typedef struct status_bar_window_phone_battery_s {
+	BatteryChargeState state;
+	bool is_known;					//false until the first update, and again after the phone disconnects
+	
+	uint8_t pending_value;			//latest update not applied yet (only if has_pending_value)
+	bool has_pending_value;
+	uint32_t interval_ms;
+	uint32_t last_apply_ms;
+	AppTimer *apply_timer;			//pending apply, NULL if none
+} status_bar_window_phone_battery_t;
+
+
+//measured text sizes, shared between all windows
+typedef struct status_bar_window_text_cache_entry_s {
+	GFont font;						//NULL if entry is unused
+	GTextAlignment alignment;
+	char text[STATUS_BAR_TEXT_CACHE_KEY_SIZE];
+	
+	GSize size;
+	uint32_t last_used;
+} status_bar_window_text_cache_entry_t;
+
+
+//advance widths of the glyphs system texts are made of (clock, AM/PM, battery percent), for one font
+typedef struct status_bar_window_glyph_table_s {
+	GFont font;
+	uint8_t advances[STATUS_BAR_GLYPH_TABLE_SIZE];
+	int16_t height;
+} status_bar_window_glyph_table_t;
+
+typedef enum {
+	STATUS_BAR_WINDOW_GLYPH_TABLE_GOTHIC_18_BOLD,
+	STATUS_BAR_WINDOW_GLYPH_TABLE_GOTHIC_14,
+	
+	STATUS_BAR_WINDOW_GLYPH_TABLE_COUNT
+} status_bar_window_glyph_table_id_t;
+
+
 //status bar windows themselves, and the data globally shared between them
 struct status_bar_window_s {
 	//internal window and handlers
@@ -50,7 +184,21 @@ struct status_bar_window_s {
 	
 	//stored values for current state
 	bool hide_time;
-	status_bar_window_layout_t *layout;
+	bool show_seconds;
+	status_bar_window_layout_t *layout;		//allocated on first build, and reused afterwards
+	bool is_layout_dirty;
+	
+	//offscreen copy of the rendered status bar (only when frame cache is enabled)
+	bool is_frame_cache_enabled;
+	GBitmap *frame_cache;
+	bool is_frame_cache_valid;
+	
+	//invalidation scheduler (every redraw the status bar asks for waits until the frame interval has passed)
+	uint32_t invalidation_interval_ms;
+	uint32_t last_flush_ms;
+	AppTimer *invalidation_timer;		//pending redraw, NULL if none
+	uint32_t rebuild_count;
+	uint32_t redraw_count;
 	
 	//pointer to more data, in case some other window type is built on top of status_bar_window
 	void *user_data;
@@ -62,15 +210,15 @@ struct status_bar_window_globals_s {
 	size_t num_windows;
 	status_bar_window_t *current_window;
 	
-	//resources and fonts
-	GBitmap *res_icon_phone;
-	GBitmap *res_icon_battery;
-	GBitmap *res_icon_charging;
-	GBitmap *res_icon_charging_half;
-	
+	//fonts (bitmaps are kept in s_status_bar_window_resources)
 	GFont res_gothic_18_bold;
 	GFont res_gothic_14;
 	
+	//text measurement cache
+	status_bar_window_text_cache_entry_t text_cache[STATUS_BAR_TEXT_CACHE_SIZE];
+	uint32_t text_cache_uses;
+	status_bar_window_glyph_table_t glyph_tables[STATUS_BAR_WINDOW_GLYPH_TABLE_COUNT];
+	
 	//current system status
 	char curr_time_text_buffer[STATUS_BAR_TIME_TEXT_BUFFER_SIZE];
 	char curr_time_suffix_text_buffer[STATUS_BAR_TIME_SUFFIX_TEXT_BUFFER_SIZE];
@@ -92,393 +240,1088 @@ struct status_bar_window_globals_s {
 
 static status_bar_window_globals_t *s_status_bar_window_globals = NULL;
 
+static status_bar_window_resources_t s_status_bar_window_resources = {
+	.keep_alive_ms = STATUS_BAR_RESOURCE_KEEP_ALIVE_MS_DEFAULT
+};
+
+static status_bar_window_phone_battery_t s_status_bar_window_phone_battery = {
+	.interval_ms = STATUS_BAR_PHONE_BATTERY_INTERVAL_MS_DEFAULT
+};
 
+static const GRect s_status_bar_window_resource_slots[STATUS_BAR_WINDOW_RESOURCE_COUNT] = {
+	[STATUS_BAR_WINDOW_RESOURCE_ICON_PHONE] = STATUS_BAR_ATLAS_SLOT_PHONE,
+	[STATUS_BAR_WINDOW_RESOURCE_ICON_BATTERY] = STATUS_BAR_ATLAS_SLOT_BATTERY,
+	[STATUS_BAR_WINDOW_RESOURCE_ICON_CHARGING] = STATUS_BAR_ATLAS_SLOT_CHARGING,
+	[STATUS_BAR_WINDOW_RESOURCE_ICON_CHARGING_HALF] = STATUS_BAR_ATLAS_SLOT_CHARGING_HALF
+};
 
-//--------------------------------//
-// Status Bar Window Layout Items //
-//--------------------------------//
 
-status_bar_window_layout_item_t *status_bar_window_layout_item_create(
-	GTextAlignment alignment,
-	status_bar_border_distance_t distance,
-	status_bar_window_layout_item_parts_t item_parts
-){
-	status_bar_window_layout_item_t *item = malloc( sizeof(*item) );
+
+//------------------//
+// Shared Resources //
+//------------------//
+
+static void status_bar_window_resources_free(void){
+	for( int resource = 0; resource < STATUS_BAR_WINDOW_RESOURCE_COUNT; resource++ ){
+		if( NULL != s_status_bar_window_resources.bitmaps[resource] ){
+			gbitmap_destroy( s_status_bar_window_resources.bitmaps[resource] );
+			s_status_bar_window_resources.bitmaps[resource] = NULL;
+			STATUS_BAR_STATS_HEAP_UNTRACK( STATUS_BAR_STATS_HEAP_RESOURCES, 0 );		//pixels belong to the atlas
+		}
+	}
 	
-	item->alignment = alignment;
-	item->distance = distance;
-	item->parts = item_parts;
-	item->next = NULL;
-	item->width = STATUS_BAR_ITEM_DISTANCE + item->parts.distance_offset;
+	//sub-bitmaps share the atlas' pixel data, so it can only go after them
+	if( NULL != s_status_bar_window_resources.atlas ){
+		STATUS_BAR_STATS_HEAP_UNTRACK(
+			STATUS_BAR_STATS_HEAP_RESOURCES, status_bar_stats_get_bitmap_bytes( s_status_bar_window_resources.atlas )
+		);
+		gbitmap_destroy( s_status_bar_window_resources.atlas );
+		s_status_bar_window_resources.atlas = NULL;
+	}
+}
+
+static void status_bar_window_resources_release_timer_callback( void *data ){
+	(void)data;
+	s_status_bar_window_resources.release_timer = NULL;
 	
-	//find icon width, if any
-	if( NULL != item_parts.icon ){
-		GRect bounds = gbitmap_get_bounds(item_parts.icon);
-		item->width += bounds.size.w;
+	if( 0 == s_status_bar_window_resources.ref_count ){
+		status_bar_window_resources_free();
 	}
+}
+
+static void status_bar_window_resources_acquire(void){
+	s_status_bar_window_resources.ref_count++;
 	
-	//find text width, if any
-	if( NULL != item_parts.text && NULL != item_parts.text_font ){
-		if( NULL != item_parts.icon ){
-			item->width += STATUS_BAR_ITEM_INTERNAL_DISTANCE;
+	//cancel pending release, if any (bitmaps are still loaded)
+	if( NULL != s_status_bar_window_resources.release_timer ){
+		app_timer_cancel( s_status_bar_window_resources.release_timer );
+		s_status_bar_window_resources.release_timer = NULL;
+	}
+}
+
+static void status_bar_window_resources_release(void){
+	if( 0 != --(s_status_bar_window_resources.ref_count) ){
+		return;
+	}
+	
+	if( 0 == s_status_bar_window_resources.keep_alive_ms ){
+		status_bar_window_resources_free();
+	} else {
+		s_status_bar_window_resources.release_timer = app_timer_register(
+			s_status_bar_window_resources.keep_alive_ms, status_bar_window_resources_release_timer_callback, NULL
+		);
+	}
+}
+
+//returns the given bitmap, loading it (and the atlas it comes from) if this is its first use
+//(NULL if the atlas couldn't be loaded, which is tried again on next use)
+static GBitmap *status_bar_window_get_resource( status_bar_window_resource_t resource ){
+	if( NULL == s_status_bar_window_resources.bitmaps[resource] ){
+		if( NULL == s_status_bar_window_resources.atlas ){
+			s_status_bar_window_resources.atlas = gbitmap_create_with_resource( RESOURCE_ID_ICON_STATUS_BAR_ATLAS );
+			if( NULL == s_status_bar_window_resources.atlas ){
+				return NULL;
+			}
+			STATUS_BAR_STATS_HEAP_TRACK(
+				STATUS_BAR_STATS_HEAP_RESOURCES, status_bar_stats_get_bitmap_bytes( s_status_bar_window_resources.atlas )
+			);
 		}
 		
-		GSize text_size = graphics_text_layout_get_content_size(
-			item_parts.text,
-			item_parts.text_font,
-			GRect(0, 0, STATUS_BAR_TEXT_WIDTH_MAX, CUSTOM_STATUS_BAR_LAYER_HEIGHT),
-			GTextOverflowModeTrailingEllipsis,
-			alignment
+		s_status_bar_window_resources.bitmaps[resource] = gbitmap_create_as_sub_bitmap(
+			s_status_bar_window_resources.atlas, s_status_bar_window_resource_slots[resource]
 		);
-		item->width += text_size.w;
+		if( NULL != s_status_bar_window_resources.bitmaps[resource] ){
+			STATUS_BAR_STATS_HEAP_TRACK( STATUS_BAR_STATS_HEAP_RESOURCES, 0 );
+		}
 	}
 	
-	return item;
+	return s_status_bar_window_resources.bitmaps[resource];
 }
 
-void status_bar_window_layout_item_destroy( status_bar_window_layout_item_t *item ){
-	free( item );
+void status_bar_window_set_resource_keep_alive( uint32_t keep_alive_ms ){
+	s_status_bar_window_resources.keep_alive_ms = keep_alive_ms;
 }
 
-void status_bar_window_layout_item_destroy_recursive( status_bar_window_layout_item_t *item ){
-	if( NULL != item ){	
-		status_bar_window_layout_item_destroy_recursive( item->next );
-		status_bar_window_layout_item_destroy( item );
+
+
+//----------------------//
+// Glyph Advance Tables //
+//----------------------//
+
+//measures every glyph of the table's set once, in the given font
+static void status_bar_window_glyph_table_init( status_bar_window_glyph_table_t *glyph_table, GFont font ){
+	glyph_table->font = font;
+	glyph_table->height = 0;
+	
+	for( int glyph = 0; glyph < STATUS_BAR_GLYPH_TABLE_SIZE; glyph++ ){
+		char text[2] = { STATUS_BAR_GLYPH_TABLE_GLYPHS[glyph], '\0' };
+		GSize glyph_size = graphics_text_layout_get_content_size(
+			text,
+			font,
+			GRect(0, 0, STATUS_BAR_TEXT_WIDTH_MAX, CUSTOM_STATUS_BAR_LAYER_HEIGHT),
+			GTextOverflowModeTrailingEllipsis,
+			GTextAlignmentLeft
+		);
+		
+		glyph_table->advances[glyph] = glyph_size.w;
+		if( glyph_size.h > glyph_table->height ){
+			glyph_table->height = glyph_size.h;
+		}
 	}
 }
 
+//returns the glyph's position in the glyph tables, or -1 if it isn't part of them
+static int status_bar_window_get_glyph_index( char glyph ){
+	if( glyph >= '0' && glyph <= '9' ){
+		return glyph - '0';
+	}
+	
+	const char *table_glyph = strchr( STATUS_BAR_GLYPH_TABLE_GLYPHS + STATUS_BAR_GLYPH_TABLE_SEPARATOR, glyph );
+	if( NULL == table_glyph || '\0' == glyph ){
+		return -1;
+	}
+	return table_glyph - STATUS_BAR_GLYPH_TABLE_GLYPHS;
+}
 
-//returns the width, in pixels, of the rendered icon
-int8_t status_bar_window_layout_item_render_icon( status_bar_window_layout_item_t *item, GContext *ctx, int8_t offset_x ){
-	if( NULL == item->parts.icon ){										//if there's no icon, do nothing
-		return 0;
+//sums up the text's glyph advances, returns false if the font or any glyph has no table
+static bool status_bar_window_measure_glyph_text( const char *text, GFont font, GSize *text_size ){
+	status_bar_window_glyph_table_t *glyph_table = NULL;
+	for( int table = 0; table < STATUS_BAR_WINDOW_GLYPH_TABLE_COUNT; table++ ){
+		if( s_status_bar_window_globals->glyph_tables[table].font == font ){
+			glyph_table = &( s_status_bar_window_globals->glyph_tables[table] );
+			break;
+		}
+	}
+	if( NULL == glyph_table ){
+		return false;
 	}
 	
-	int internal_distance = 0;
-	if( NULL != item->parts.text && NULL != item->parts.text_font ){	//add internal offset between text and icon, if needed
-		internal_distance = STATUS_BAR_ITEM_INTERNAL_DISTANCE;
+	int width = 0;
+	for( const char *c = text; '\0' != *c; c++ ){
+		int glyph = status_bar_window_get_glyph_index( *c );
+		if( glyph < 0 ){
+			return false;
+		}
+		width += glyph_table->advances[glyph];
 	}
 	
-	GRect bounds = gbitmap_get_bounds(item->parts.icon);
+	if( width > STATUS_BAR_TEXT_WIDTH_MAX ){
+		width = STATUS_BAR_TEXT_WIDTH_MAX;
+	}
+	*text_size = GSize( width, ( width > 0 ) ? glyph_table->height : 0 );
+	return true;
+}
 
-	int icon_x = offset_x;
-	int icon_y = ( CUSTOM_STATUS_BAR_LAYER_HEIGHT - bounds.size.h + 1 ) / 2;		//( the "+1" makes it round up )
 
-	if( item->alignment == GTextAlignmentRight){
-		icon_x = STATUS_BAR_WINDOW_WIDTH - icon_x - bounds.size.w - internal_distance;
-	}
 
-	graphics_context_set_compositing_mode( ctx, STATUS_BAR_COMP_OP_NORMAL );
-	graphics_draw_bitmap_in_rect( 
-		ctx, item->parts.icon,
-		GRect(
-			icon_x,
-			icon_y,
-			bounds.size.w,
-			bounds.size.h
-		)
-	);
+//------------------------//
+// Text Measurement Cache //
+//------------------------//
 
-	if( NULL != item->parts.battery_state ){
-		GRect battery_icon_bounds = gbitmap_get_bounds( s_status_bar_window_globals->res_icon_charging );
-		battery_icon_bounds.origin.x += icon_x + item->parts.battery_icon_origin.x;
-		battery_icon_bounds.origin.y += icon_y + item->parts.battery_icon_origin.y;
+//returns the size of the given text, measuring it only if it isn't cached yet (or summing its glyphs, for system texts)
+static GSize status_bar_window_measure_text( const char *text, GFont font, GTextAlignment alignment ){
+	GSize text_size;
+	if( status_bar_window_measure_glyph_text( text, font, &text_size ) ){
+		STATUS_BAR_STATS_INCREMENT( STATUS_BAR_STATS_COUNTER_GLYPH_TABLE_HIT );
+		return text_size;
+	}
+	
+	status_bar_window_text_cache_entry_t *cache = s_status_bar_window_globals->text_cache;
+	status_bar_window_text_cache_entry_t *oldest = &(cache[0]);
+	
+	size_t text_length = strlen( text );
+	bool is_cacheable = ( text_length < STATUS_BAR_TEXT_CACHE_KEY_SIZE );
+	
+	if( is_cacheable ){
+		for( int i = 0; i < STATUS_BAR_TEXT_CACHE_SIZE; i++ ){
+			if(
+				( cache[i].font == font ) &&
+				( cache[i].alignment == alignment ) &&
+				( 0 == strcmp( cache[i].text, text ) )
+			){
+				STATUS_BAR_STATS_INCREMENT( STATUS_BAR_STATS_COUNTER_TEXT_CACHE_HIT );
+				cache[i].last_used = ++(s_status_bar_window_globals->text_cache_uses);
+				return cache[i].size;
+			}
+			
+			if( cache[i].last_used < oldest->last_used ){
+				oldest = &(cache[i]);
+			}
+		}
+	}
+	
+	STATUS_BAR_STATS_INCREMENT( STATUS_BAR_STATS_COUNTER_TEXT_CACHE_MISS );
+	text_size = graphics_text_layout_get_content_size(
+		text,
+		font,
+		GRect(0, 0, STATUS_BAR_TEXT_WIDTH_MAX, CUSTOM_STATUS_BAR_LAYER_HEIGHT),
+		GTextOverflowModeTrailingEllipsis,
+		alignment
+	);
+	
+	//replace least recently used entry
+	if( is_cacheable ){
+		oldest->font = font;
+		oldest->alignment = alignment;
+		memcpy( oldest->text, text, text_length + 1 );
+		oldest->size = text_size;
+		oldest->last_used = ++(s_status_bar_window_globals->text_cache_uses);
+	}
+	
+	return text_size;
+}
 
-		int missing_charge_percent = ( STATUS_BAR_BATTERY_CHARGE_MAX - item->parts.battery_state->charge_percent );
+//returns the room taken by the widest possible seconds clock
+static GSize status_bar_window_get_seconds_clock_size(void){
+	status_bar_window_glyph_table_t *glyph_table = &( s_status_bar_window_globals->glyph_tables[STATUS_BAR_WINDOW_GLYPH_TABLE_GOTHIC_18_BOLD] );
+	
+	int digit_width = 0;
+	for( int digit = 0; digit <= 9; digit++ ){
+		if( glyph_table->advances[digit] > digit_width ){
+			digit_width = glyph_table->advances[digit];
+		}
+	}
+	
+	return GSize(
+		STATUS_BAR_SECONDS_CLOCK_DIGITS * digit_width +
+			STATUS_BAR_SECONDS_CLOCK_SEPARATORS * glyph_table->advances[STATUS_BAR_GLYPH_TABLE_SEPARATOR],
+		glyph_table->height
+	);
+}
 
-		if( item->parts.battery_state->is_charging ){		// || item->parts.battery_state->is_plugged ){
-			if( item->parts.battery_state->charge_percent <= STATUS_BAR_BATTERY_CHARGE_THRESHOLD ){
-				//draw "empty" charging icon
-				graphics_context_set_compositing_mode( ctx, STATUS_BAR_COMP_OP_NORMAL );
-				graphics_draw_bitmap_in_rect( ctx, s_status_bar_window_globals->res_icon_charging, battery_icon_bounds );
 
-			} else if( missing_charge_percent < STATUS_BAR_BATTERY_CHARGE_THRESHOLD ){
-				//draw "full" charging icon
-				graphics_context_set_compositing_mode( ctx, STATUS_BAR_COMP_OP_INVERTED );
-				graphics_draw_bitmap_in_rect( ctx, s_status_bar_window_globals->res_icon_charging, battery_icon_bounds );
 
-			} else {
-				//draw "halfway" charging icon
-				graphics_context_set_compositing_mode( ctx, STATUS_BAR_COMP_OP_NORMAL );
-				graphics_draw_bitmap_in_rect( ctx, s_status_bar_window_globals->res_icon_charging_half, battery_icon_bounds );
-			}
+//--------------------------------//
+// Status Bar Window Layout Items //
+//--------------------------------//
 
+static status_bar_window_battery_visual_t status_bar_window_get_battery_visual(
+	const BatteryChargeState *battery_state,
+	int battery_full_missing_percent,
+	int battery_empty_missing_percent,
+	int area_height
+){
+	status_bar_window_battery_visual_t visual = { .glyph = STATUS_BAR_BATTERY_GLYPH_FILL, .missing_height = 0 };
+	int missing_charge_percent = ( STATUS_BAR_BATTERY_CHARGE_MAX - battery_state->charge_percent );
+	
+	if( battery_state->is_charging ){		// || battery_state->is_plugged ){
+		if( battery_state->charge_percent <= STATUS_BAR_BATTERY_CHARGE_THRESHOLD ){
+			visual.glyph = STATUS_BAR_BATTERY_GLYPH_CHARGING_EMPTY;
+		} else if( missing_charge_percent < STATUS_BAR_BATTERY_CHARGE_THRESHOLD ){
+			visual.glyph = STATUS_BAR_BATTERY_GLYPH_CHARGING_FULL;
 		} else {
+			visual.glyph = STATUS_BAR_BATTERY_GLYPH_CHARGING_HALF;
+		}
+		
+	} else {
+		//recalculate height to account for how fully charged the device is (round toward full)
+		if( missing_charge_percent < battery_full_missing_percent ){
+			missing_charge_percent = battery_full_missing_percent;
 			
-			//recalculate Y and height to account for how fully charged the device is (round toward full)
-			if( missing_charge_percent < item->parts.battery_full_missing_percent ){
-				missing_charge_percent = item->parts.battery_full_missing_percent;
-				
-			} else if( missing_charge_percent > item->parts.battery_empty_missing_percent ){
-				missing_charge_percent = item->parts.battery_empty_missing_percent;
-				
-			}
-			int	missing_h =  (missing_charge_percent - item->parts.battery_full_missing_percent) *
-					battery_icon_bounds.size.h /
-					(item->parts.battery_empty_missing_percent - item->parts.battery_full_missing_percent);
+		} else if( missing_charge_percent > battery_empty_missing_percent ){
+			missing_charge_percent = battery_empty_missing_percent;
 			
-			battery_icon_bounds.origin.y += missing_h;
-			battery_icon_bounds.size.h -= missing_h;
+		}
+		visual.missing_height = (missing_charge_percent - battery_full_missing_percent) *
+				area_height /
+				(battery_empty_missing_percent - battery_full_missing_percent);
+	}
+	
+	return visual;
+}
 
-			//fill charged rectangle
-			graphics_context_set_fill_color( ctx, STATUS_BAR_WINDOW_COLOR_FOREGROUND );
-			graphics_fill_rect( ctx, battery_icon_bounds, 0, GCornerNone );
+//takes the next free item from the layout (returns NULL if the layout is full)
+status_bar_window_layout_item_t *status_bar_window_layout_item_create(
+	status_bar_window_layout_t *status_bar_window_layout,
+	GTextAlignment alignment,
+	status_bar_border_distance_t distance,
+	status_bar_window_layout_item_parts_t item_parts,
+	status_bar_item_t *source
+){
+	if( status_bar_window_layout->item_count >= status_bar_window_layout->item_capacity ){
+		return NULL;
+	}
+	status_bar_window_layout_item_t *item = &( status_bar_window_layout->items[ status_bar_window_layout->item_count++ ] );
+	
+	item->alignment = alignment;
+	item->distance = distance;
+	item->distance_offset = item_parts.distance_offset;
+	item->text = item_parts.text;
+	item->text_font = item_parts.text_font;
+	item->icon = item_parts.icon;
+	item->source = source;
+	
+	item->is_text_size_fixed = ( item_parts.text_fixed_size.w != 0 );
+	item->text_size = item_parts.text_fixed_size;
+	
+	item->battery = NULL;
+	if( NULL != item_parts.battery_state ){
+		if( status_bar_window_layout->battery_count >= STATUS_BAR_LAYOUT_BATTERY_CAPACITY ){
+			status_bar_window_layout->item_count--;		//give item back
+			return NULL;
 		}
+		item->battery = &( status_bar_window_layout->batteries[ status_bar_window_layout->battery_count++ ] );
+		
+		item->battery->state = item_parts.battery_state;
+		item->battery->full_missing_percent = item_parts.battery_full_missing_percent;
+		item->battery->empty_missing_percent = item_parts.battery_empty_missing_percent;
+		
+		//charge is drawn where the charging glyph goes (sized from its atlas slot, as sub-bitmap bounds keep the atlas origin)
+		item->battery->area = GRect(
+			item_parts.battery_icon_origin.x,
+			item_parts.battery_icon_origin.y,
+			s_status_bar_window_resource_slots[STATUS_BAR_WINDOW_RESOURCE_ICON_CHARGING].size.w,
+			s_status_bar_window_resource_slots[STATUS_BAR_WINDOW_RESOURCE_ICON_CHARGING].size.h
+		);
 	}
+	
+	status_bar_window_layout_item_update_width( item );
+	
+	return item;
+}
 
-	return bounds.size.w + internal_distance;
+void status_bar_window_layout_item_update_width( status_bar_window_layout_item_t *item ){
+	item->width = STATUS_BAR_ITEM_DISTANCE + item->distance_offset;
+	
+	//find icon width, if any
+	if( NULL != item->icon ){
+		GRect bounds = gbitmap_get_bounds(item->icon);
+		item->width += bounds.size.w;
+	}
+	
+	//find text width, if any (and remember text size for rendering, unless it's fixed)
+	if( !item->is_text_size_fixed ){
+		item->text_size = GSize(0, 0);
+	}
+	if( NULL != item->text && NULL != item->text_font ){
+		if( NULL != item->icon ){
+			item->width += STATUS_BAR_ITEM_INTERNAL_DISTANCE;
+		}
+		
+		if( !item->is_text_size_fixed ){
+			item->text_size = status_bar_window_measure_text( item->text, item->text_font, item->alignment );
+		}
+		item->width += item->text_size.w;
+	}
 }
 
-//returns the width, in pixels, of the rendered text
-int8_t status_bar_window_layout_item_render_text( status_bar_window_layout_item_t *item, GContext *ctx, int8_t offset_x ){
-	if( NULL == item->parts.text || NULL == item->parts.text_font ){			//if there's no text or no font, do nothing
-		return 0;
+
+
+//works out where the item's icon and text go, and returns the new value for offset_x
+int8_t status_bar_window_layout_item_place( status_bar_window_layout_item_t *item, int8_t offset_x ){
+	bool has_icon = ( NULL != item->icon );
+	bool has_text = ( NULL != item->text && NULL != item->text_font );
+	int internal_distance = ( has_icon && has_text ) ? STATUS_BAR_ITEM_INTERNAL_DISTANCE : 0;
+	int icon_width = has_icon ? gbitmap_get_bounds(item->icon).size.w : 0;
+	int text_width = has_text ? item->text_size.w : 0;
+	
+	offset_x += STATUS_BAR_ITEM_DISTANCE + item->distance_offset;
+	
+	//right aligned items go from the right border inwards, so their text comes before their icon
+	if( item->alignment == GTextAlignmentRight ){
+		item->text_x = STATUS_BAR_WINDOW_WIDTH - offset_x - text_width;
+		offset_x += text_width;
+		item->icon_x = STATUS_BAR_WINDOW_WIDTH - offset_x - icon_width - internal_distance;
+		offset_x += icon_width + internal_distance;
+	} else {
+		item->icon_x = offset_x;
+		offset_x += icon_width + internal_distance;
+		item->text_x = offset_x;
+		offset_x += text_width;
 	}
 	
-	GSize text_size = graphics_text_layout_get_content_size(
-		item->parts.text,
-		item->parts.text_font,
-		GRect(0, 0, STATUS_BAR_TEXT_WIDTH_MAX, CUSTOM_STATUS_BAR_LAYER_HEIGHT),
-		GTextOverflowModeTrailingEllipsis,
-		item->alignment	
+	//only the current charge's fill height is needed (a few integer ops, so it isn't worth a table)
+	if( NULL != item->battery ){
+		item->battery->visual = status_bar_window_get_battery_visual(
+			item->battery->state, item->battery->full_missing_percent, item->battery->empty_missing_percent, item->battery->area.size.h
+		);
+	}
+	
+	return offset_x;
+}
+
+static GRect status_bar_window_layout_item_get_icon_rect( status_bar_window_layout_item_t *item ){
+	GRect bounds = gbitmap_get_bounds(item->icon);
+	
+	return GRect(
+		item->icon_x,
+		( CUSTOM_STATUS_BAR_LAYER_HEIGHT - bounds.size.h + 1 ) / 2,		//( the "+1" makes it round up )
+		bounds.size.w,
+		bounds.size.h
 	);
+}
+
+//returns where the battery charge is drawn, in status bar coordinates
+static GRect status_bar_window_layout_item_get_battery_rect( status_bar_window_layout_item_t *item ){
+	GRect icon_rect = status_bar_window_layout_item_get_icon_rect( item );
+	GRect battery_rect = item->battery->area;
+	battery_rect.origin.x += icon_rect.origin.x;
+	battery_rect.origin.y += icon_rect.origin.y;
+	
+	return battery_rect;
+}
+
 
-	int text_x = offset_x;
-	if( item->alignment == GTextAlignmentRight){
-		text_x = STATUS_BAR_WINDOW_WIDTH - text_x - text_size.w;
+#ifdef STATUS_BAR_ENABLE_PROFILING
+//returns the profiling point for rendering the given item (system items are profiled separately)
+static status_bar_profile_point_t status_bar_window_layout_get_profile_point(
+	status_bar_window_layout_t *status_bar_window_layout,
+	status_bar_window_layout_item_t *item
+){
+	static const status_bar_profile_point_t system_item_points[STATUS_BAR_WINDOW_SYSTEM_ITEM_COUNT] = {
+		[STATUS_BAR_WINDOW_SYSTEM_ITEM_TIME] = STATUS_BAR_PROFILE_POINT_RENDER_TIME,
+		[STATUS_BAR_WINDOW_SYSTEM_ITEM_TIME_SUFFIX] = STATUS_BAR_PROFILE_POINT_RENDER_TIME_SUFFIX,
+		[STATUS_BAR_WINDOW_SYSTEM_ITEM_BATTERY_ICON] = STATUS_BAR_PROFILE_POINT_RENDER_BATTERY_ICON,
+		[STATUS_BAR_WINDOW_SYSTEM_ITEM_PHONE_ICON] = STATUS_BAR_PROFILE_POINT_RENDER_PHONE_ICON,
+		[STATUS_BAR_WINDOW_SYSTEM_ITEM_BATTERY_TEXT] = STATUS_BAR_PROFILE_POINT_RENDER_BATTERY_TEXT
+	};
+	
+	if( NULL == item->source ){
+		for( int system_item = 0; system_item < STATUS_BAR_WINDOW_SYSTEM_ITEM_COUNT; system_item++ ){
+			if( status_bar_window_layout->system_items[system_item] == item ){
+				return system_item_points[system_item];
+			}
+		}
 	}
+	
+	return STATUS_BAR_PROFILE_POINT_RENDER_CATALOG_ITEM;
+}
+#endif
 
-	graphics_context_set_text_color( ctx, STATUS_BAR_WINDOW_COLOR_FOREGROUND );
-	graphics_draw_text(
-		ctx, item->parts.text, item->parts.text_font,
-		GRect(
-			text_x,
-			STATUS_BAR_TEXT_ADJUST_Y + CUSTOM_STATUS_BAR_LAYER_HEIGHT - text_size.h,
-			text_size.w,
-			text_size.h
-		),
-		GTextOverflowModeTrailingEllipsis,
-		item->alignment,
-		NULL
-	);
+//appends a command to the zone's display list, and returns it
+static status_bar_window_draw_command_t *status_bar_window_layout_add_command(
+	status_bar_window_layout_t *status_bar_window_layout,
+	status_bar_window_zone_t zone,
+	status_bar_window_draw_type_t type,
+	GRect rect,
+	status_bar_window_layout_item_t *item
+){
+	status_bar_window_draw_command_t *command = &( status_bar_window_layout->commands[
+		status_bar_window_layout->command_start[zone] + status_bar_window_layout->command_count[zone]++
+	] );
+	
+	command->type = type;
+	command->alignment = item->alignment;
+	#ifdef STATUS_BAR_ENABLE_PROFILING
+		command->profile_point = status_bar_window_layout_get_profile_point( status_bar_window_layout, item );
+	#endif
+	command->rect = rect;
+	command->bitmap = NULL;
+	command->text = NULL;
+	command->text_font = NULL;
+	
+	return command;
+}
 
-	return text_size.w;
+//appends a bitmap command to the zone's display list, unless there's no bitmap (e.g. the atlas couldn't be loaded)
+static void status_bar_window_layout_add_bitmap_command(
+	status_bar_window_layout_t *status_bar_window_layout,
+	status_bar_window_zone_t zone,
+	status_bar_window_draw_type_t type,
+	GRect rect,
+	status_bar_window_layout_item_t *item,
+	GBitmap *bitmap
+){
+	if( NULL == bitmap ){
+		return;
+	}
+	
+	status_bar_window_draw_command_t *command = status_bar_window_layout_add_command( status_bar_window_layout, zone, type, rect, item );
+	command->bitmap = bitmap;
 }
 
-//returns the new value for offset_x, after rendering the given icon/text
-int8_t status_bar_window_layout_item_render( status_bar_window_layout_item_t *item, GContext *ctx, int8_t offset_x ){
-	offset_x += STATUS_BAR_ITEM_DISTANCE + item->parts.distance_offset;
+//compiles a zone's items into display list commands, grouping draws that share graphics state
+//(bitmaps drawn as they are, then inverted bitmaps and fills, then texts)
+static void status_bar_window_layout_compile_zone( status_bar_window_layout_t *status_bar_window_layout, status_bar_window_zone_t zone ){
+	status_bar_window_layout_item_t *first = &( status_bar_window_layout->items[ status_bar_window_layout->zone_start[zone] ] );
+	status_bar_window_layout_item_t *end = first + status_bar_window_layout->zone_count[zone];
+	status_bar_window_layout_item_t *item;
+	status_bar_window_draw_command_t *command;
+	
+	//center items are placed from the left, left and right ones from their own screen border
+	int8_t offset_x = 0;
+	if( zone == STATUS_BAR_WINDOW_ZONE_CENTER ){
+		offset_x = ( STATUS_BAR_WINDOW_WIDTH - status_bar_window_layout->center_width ) / 2;
+	}
+	for( item = first; item < end; item++ ){
+		offset_x = status_bar_window_layout_item_place( item, offset_x );
+	}
+	
+	//icons, then the charging glyphs on top of battery icons
+	for( item = first; item < end; item++ ){
+		if( NULL == item->icon ){
+			continue;
+		}
 		
-	//render text before icon (if right aligned)
-	if( item->alignment == GTextAlignmentRight ){
-		offset_x += status_bar_window_layout_item_render_text( item, ctx, offset_x );
+		status_bar_window_layout_add_bitmap_command(
+			status_bar_window_layout, zone, STATUS_BAR_WINDOW_DRAW_BITMAP, status_bar_window_layout_item_get_icon_rect( item ), item,
+			item->icon
+		);
+		
+		if( NULL == item->battery ){
+			continue;
+		}
+		switch( item->battery->visual.glyph ){
+		  case STATUS_BAR_BATTERY_GLYPH_CHARGING_EMPTY:
+			//"empty" charging icon
+			status_bar_window_layout_add_bitmap_command(
+				status_bar_window_layout, zone, STATUS_BAR_WINDOW_DRAW_BITMAP, status_bar_window_layout_item_get_battery_rect( item ), item,
+				status_bar_window_get_resource( STATUS_BAR_WINDOW_RESOURCE_ICON_CHARGING )
+			);
+			break;
+			
+		  case STATUS_BAR_BATTERY_GLYPH_CHARGING_HALF:
+			//"halfway" charging icon
+			status_bar_window_layout_add_bitmap_command(
+				status_bar_window_layout, zone, STATUS_BAR_WINDOW_DRAW_BITMAP, status_bar_window_layout_item_get_battery_rect( item ), item,
+				status_bar_window_get_resource( STATUS_BAR_WINDOW_RESOURCE_ICON_CHARGING_HALF )
+			);
+			break;
+			
+		  default:
+			break;
+		}
 	}
 	
-	//render icon
-	offset_x += status_bar_window_layout_item_render_icon( item, ctx, offset_x );
+	//"full" charging icons, and charged part of battery icons
+	for( item = first; item < end; item++ ){
+		if( NULL == item->battery || NULL == item->icon ){
+			continue;
+		}
+		
+		GRect battery_rect = status_bar_window_layout_item_get_battery_rect( item );
+		switch( item->battery->visual.glyph ){
+		  case STATUS_BAR_BATTERY_GLYPH_CHARGING_FULL:
+			status_bar_window_layout_add_bitmap_command(
+				status_bar_window_layout, zone, STATUS_BAR_WINDOW_DRAW_BITMAP_INVERTED, battery_rect, item,
+				status_bar_window_get_resource( STATUS_BAR_WINDOW_RESOURCE_ICON_CHARGING )
+			);
+			break;
+			
+		  case STATUS_BAR_BATTERY_GLYPH_FILL:
+			battery_rect.origin.y += item->battery->visual.missing_height;
+			battery_rect.size.h -= item->battery->visual.missing_height;
+			status_bar_window_layout_add_command( status_bar_window_layout, zone, STATUS_BAR_WINDOW_DRAW_FILL, battery_rect, item );
+			break;
+			
+		  default:
+			break;
+		}
+	}
 	
-	//render text after icon (if not right aligned)
-	if( item->alignment != GTextAlignmentRight ){
-		offset_x += status_bar_window_layout_item_render_text( item, ctx, offset_x );
+	//texts
+	for( item = first; item < end; item++ ){
+		if( NULL == item->text || NULL == item->text_font ){
+			continue;
+		}
+		
+		command = status_bar_window_layout_add_command(
+			status_bar_window_layout, zone, STATUS_BAR_WINDOW_DRAW_TEXT,
+			GRect(
+				item->text_x,
+				STATUS_BAR_TEXT_ADJUST_Y + CUSTOM_STATUS_BAR_LAYER_HEIGHT - item->text_size.h,
+				item->text_size.w,
+				item->text_size.h
+			),
+			item
+		);
+		command->text = item->text;
+		command->text_font = item->text_font;
+	}
+}
+
+void status_bar_window_layout_compile( status_bar_window_layout_t *status_bar_window_layout ){
+	//room for the most commands these items can compile to
+	size_t command_capacity = status_bar_window_layout->item_count * STATUS_BAR_LAYOUT_COMMANDS_PER_ITEM +
+		status_bar_window_layout->battery_count * STATUS_BAR_LAYOUT_COMMANDS_PER_BATTERY;
+	if( status_bar_window_layout->command_capacity < command_capacity ){
+		STATUS_BAR_FREE( status_bar_window_layout->commands );
+		status_bar_window_layout->commands = STATUS_BAR_MALLOC(
+			STATUS_BAR_STATS_HEAP_LAYOUT, command_capacity * sizeof( *(status_bar_window_layout->commands) )
+		);
+		status_bar_window_layout->command_capacity = command_capacity;
 	}
 	
-	//return updated X offset
-	return offset_x;
+	//each zone's commands go right after the previous zone's
+	uint16_t command_start = 0;
+	for( int zone = 0; zone < STATUS_BAR_WINDOW_ZONE_COUNT; zone++ ){
+		status_bar_window_layout->command_start[zone] = command_start;
+		status_bar_window_layout->command_count[zone] = 0;
+		
+		status_bar_window_layout_compile_zone( status_bar_window_layout, zone );
+		command_start += status_bar_window_layout->command_count[zone];
+	}
+	
+	status_bar_window_layout->is_display_list_valid = true;
+}
+
+//replays the zone's display list (compiling it first, if items changed since last time),
+//setting each piece of graphics state only when it differs from the previous command's
+void status_bar_window_layout_render_zone( status_bar_window_layout_t *status_bar_window_layout, status_bar_window_zone_t zone, GContext *ctx ){
+	if( !status_bar_window_layout->is_display_list_valid ){
+		status_bar_window_layout_compile( status_bar_window_layout );
+	}
+	
+	status_bar_window_draw_command_t *command = &( status_bar_window_layout->commands[ status_bar_window_layout->command_start[zone] ] );
+	status_bar_window_draw_command_t *end = command + status_bar_window_layout->command_count[zone];
+	
+	bool is_comp_op_set = false;
+	GCompOp comp_op = STATUS_BAR_COMP_OP_NORMAL;
+	bool is_fill_color_set = false;
+	bool is_text_color_set = false;
+	
+	#ifdef STATUS_BAR_ENABLE_PROFILING
+		//each command's time is charged to its item's profiling point (one clock read per command),
+		//and recorded once per point, when the zone is done
+		uint32_t profile_elapsed[STATUS_BAR_PROFILE_POINT_COUNT] = { 0 };
+		uint32_t profile_points_used = 0;
+		uint32_t profile_last = STATUS_BAR_PROFILE_CLOCK();
+	#endif
+	
+	for( ; command < end; command++ ){
+		switch( command->type ){
+		  case STATUS_BAR_WINDOW_DRAW_BITMAP:
+		  case STATUS_BAR_WINDOW_DRAW_BITMAP_INVERTED: {
+			GCompOp command_comp_op = ( command->type == STATUS_BAR_WINDOW_DRAW_BITMAP ) ? STATUS_BAR_COMP_OP_NORMAL : STATUS_BAR_COMP_OP_INVERTED;
+			if( !is_comp_op_set || comp_op != command_comp_op ){
+				graphics_context_set_compositing_mode( ctx, command_comp_op );
+				comp_op = command_comp_op;
+				is_comp_op_set = true;
+			}
+			graphics_draw_bitmap_in_rect( ctx, command->bitmap, command->rect );
+			break;
+		  }
+			
+		  case STATUS_BAR_WINDOW_DRAW_FILL:
+			if( !is_fill_color_set ){
+				graphics_context_set_fill_color( ctx, STATUS_BAR_WINDOW_COLOR_FOREGROUND );
+				is_fill_color_set = true;
+			}
+			graphics_fill_rect( ctx, command->rect, 0, GCornerNone );
+			break;
+			
+		  case STATUS_BAR_WINDOW_DRAW_TEXT:
+			if( !is_text_color_set ){
+				graphics_context_set_text_color( ctx, STATUS_BAR_WINDOW_COLOR_FOREGROUND );
+				is_text_color_set = true;
+			}
+			graphics_draw_text(
+				ctx, command->text, command->text_font, command->rect,
+				GTextOverflowModeTrailingEllipsis,
+				command->alignment,
+				NULL
+			);
+			break;
+		}
+		
+		#ifdef STATUS_BAR_ENABLE_PROFILING
+			uint32_t profile_now = STATUS_BAR_PROFILE_CLOCK();
+			profile_elapsed[command->profile_point] += profile_now - profile_last;
+			profile_points_used |= (uint32_t)1 << command->profile_point;
+			profile_last = profile_now;
+		#endif
+	}
+	
+	#ifdef STATUS_BAR_ENABLE_PROFILING
+		for( int point = 0; point < STATUS_BAR_PROFILE_POINT_COUNT; point++ ){
+			if( profile_points_used & ( (uint32_t)1 << point ) ){
+				status_bar_profile_record( point, profile_elapsed[point] );
+			}
+		}
+	#endif
 }
 
 //--------------------------//
 // Status Bar Window Layout //
 //--------------------------//
 
-status_bar_window_layout_t *status_bar_window_layout_create(void){
-	status_bar_window_layout_t *status_bar_window_layout = malloc( sizeof(*status_bar_window_layout) );
+status_bar_window_layout_t *status_bar_window_layout_create( size_t item_capacity ){
+	status_bar_window_layout_t *status_bar_window_layout = STATUS_BAR_MALLOC( STATUS_BAR_STATS_HEAP_LAYOUT, sizeof(*status_bar_window_layout) );
+	
+	status_bar_window_layout->items = STATUS_BAR_MALLOC( STATUS_BAR_STATS_HEAP_LAYOUT, item_capacity * sizeof( *(status_bar_window_layout->items) ) );
+	status_bar_window_layout->item_capacity = item_capacity;
+	status_bar_window_layout->commands = NULL;		//allocated on first compile, for the items actually laid out
+	status_bar_window_layout->command_capacity = 0;
+	
+	status_bar_window_layout_reset( status_bar_window_layout );
+	
+	return status_bar_window_layout;
+}
+
+void status_bar_window_layout_reset( status_bar_window_layout_t *status_bar_window_layout ){
+	status_bar_window_layout->item_count = 0;
+	status_bar_window_layout->battery_count = 0;
+	
+	for( int zone = 0; zone < STATUS_BAR_WINDOW_ZONE_COUNT; zone++ ){
+		status_bar_window_layout->zone_start[zone] = 0;
+		status_bar_window_layout->zone_count[zone] = 0;
+		status_bar_window_layout->command_start[zone] = 0;
+		status_bar_window_layout->command_count[zone] = 0;
+		
+		for( int distance = 0; distance < STATUS_BAR_BORDER_DISTANCE_COUNT; distance++ ){
+			status_bar_window_layout->bucket_count[zone][distance] = 0;
+		}
+	}
 	
 	status_bar_window_layout->left_width = 0;
 	status_bar_window_layout->center_width = 0;
 	status_bar_window_layout->right_width = 0;
 	
-	status_bar_window_layout->left_max_distance = STATUS_BAR_BORDER_DISTANCE_SYSTEM_ICON;
-	status_bar_window_layout->center_max_distance = STATUS_BAR_BORDER_DISTANCE_SYSTEM_ICON;
-	status_bar_window_layout->right_max_distance = STATUS_BAR_BORDER_DISTANCE_SYSTEM_ICON;
+	for( int i = 0; i < STATUS_BAR_WINDOW_SYSTEM_ITEM_COUNT; i++ ){
+		status_bar_window_layout->system_items[i] = NULL;
+	}
+	status_bar_window_layout->has_rejected_items = false;
+	status_bar_window_layout->is_display_list_valid = false;
+}
+
+void status_bar_window_layout_destroy( status_bar_window_layout_t *status_bar_window_layout ){
+	STATUS_BAR_FREE( status_bar_window_layout->items );
+	STATUS_BAR_FREE( status_bar_window_layout->commands );
+	STATUS_BAR_FREE( status_bar_window_layout );
+}
+
+
+//returns true if the current side widths fit the screen, after growing the side with the given alignment
+static bool status_bar_window_layout_fits( status_bar_window_layout_t *status_bar_window_layout, GTextAlignment alignment ){
+	if( status_bar_window_layout->center_width == 0){	// [Left      ...       Right]
+		if( 
+			status_bar_window_layout->left_width + STATUS_BAR_ITEM_DISTANCE + status_bar_window_layout->right_width >
+			STATUS_BAR_WINDOW_WIDTH
+		){
+			return false;
+		}
+			
+	} else {											// [Left ... Center ... Right]
+		
+		if(
+			( alignment != GTextAlignmentRight ) &&		// [Left ... Cen|            ]
+			(
+				2 * ( status_bar_window_layout->left_width + STATUS_BAR_ITEM_DISTANCE ) + status_bar_window_layout->center_width >
+				STATUS_BAR_WINDOW_WIDTH
+			)
+		){
+			return false;
+			
+		} else if(
+			( alignment != GTextAlignmentLeft ) &&		// [            |er ... Right]
+			(
+				status_bar_window_layout->center_width +  2 * ( STATUS_BAR_ITEM_DISTANCE + status_bar_window_layout->right_width ) >
+				STATUS_BAR_WINDOW_WIDTH
+			)
+		){
+			return false;
+		}
+		
+	}
+	
+	return true;
+}
+
+//returns the width of the side with the given alignment (NULL if alignment is invalid)
+static uint8_t *status_bar_window_layout_get_side_width( status_bar_window_layout_t *status_bar_window_layout, GTextAlignment alignment ){
+	switch( alignment ){
+	  case GTextAlignmentLeft:
+		return &(status_bar_window_layout->left_width);
+	  case GTextAlignmentRight:
+		return &(status_bar_window_layout->right_width);
+	  case GTextAlignmentCenter:
+		return &(status_bar_window_layout->center_width);
+	  default:
+		return NULL;
+	}
+}
+
+
+//returns the zone where items with the given alignment are drawn
+static status_bar_window_zone_t status_bar_window_get_zone( GTextAlignment alignment ){
+	switch( alignment ){
+	  case GTextAlignmentLeft:
+		return STATUS_BAR_WINDOW_ZONE_LEFT;
+	  case GTextAlignmentRight:
+		return STATUS_BAR_WINDOW_ZONE_RIGHT;
+	  default:
+		return STATUS_BAR_WINDOW_ZONE_CENTER;
+	}
+}
+
+status_bar_window_layout_item_t *status_bar_window_layout_add_item(		//returns the added item, or NULL if it wouldn't fit
+	status_bar_window_layout_t *status_bar_window_layout,
+	GTextAlignment alignment,
+	status_bar_border_distance_t distance,
+	status_bar_window_layout_item_parts_t item_parts,
+	status_bar_item_t *source
+){
+	
+	
+	uint8_t *curr_side_width = status_bar_window_layout_get_side_width( status_bar_window_layout, alignment );
+	if( NULL == curr_side_width || distance >= STATUS_BAR_BORDER_DISTANCE_COUNT ){
+		//this should't happen, but if it does, abort operation
+		return NULL;
+	}
+
+	status_bar_window_layout_item_t *item = status_bar_window_layout_item_create(
+		status_bar_window_layout, alignment, distance, item_parts, source
+	);
+	if( NULL == item ){
+		status_bar_window_layout->has_rejected_items = true;
+		return NULL;
+	}
+
+	*curr_side_width += item->width;
 	
-	status_bar_window_layout->left_first = NULL;
-	status_bar_window_layout->left_last_next_ptr = &(status_bar_window_layout->left_first);
+	if( !status_bar_window_layout_fits( status_bar_window_layout, alignment ) ){
+		*curr_side_width -= item->width;
+		status_bar_window_layout->item_count--;		//item was the last one taken, so give it back
+		if( NULL != item->battery ){
+			status_bar_window_layout->battery_count--;
+		}
+		status_bar_window_layout->has_rejected_items = true;
+		return NULL;
+	}
 	
-	status_bar_window_layout->center_first = NULL;
-	status_bar_window_layout->center_last_next_ptr = &(status_bar_window_layout->center_first);
+	//item's final position is only known once every item was added (see status_bar_window_layout_finish)
+	item->rank = status_bar_window_layout->bucket_count[ status_bar_window_get_zone( alignment ) ][ distance ]++;
 	
-	status_bar_window_layout->right_first = NULL;
-	status_bar_window_layout->right_last_next_ptr = &(status_bar_window_layout->right_first);
-		
-	return status_bar_window_layout;
+	return item;
 }
 
-void status_bar_window_layout_destroy( status_bar_window_layout_t *status_bar_window_layout ){
-	status_bar_window_layout_item_destroy_recursive( status_bar_window_layout->left_first );
-	status_bar_window_layout_item_destroy_recursive( status_bar_window_layout->center_first );
-	status_bar_window_layout_item_destroy_recursive( status_bar_window_layout->right_first );
+//where the item goes in render order, given where each of its zone's distances starts
+static size_t status_bar_window_layout_item_get_position(
+	status_bar_window_layout_item_t *item,
+	uint16_t bucket_start[STATUS_BAR_WINDOW_ZONE_COUNT][STATUS_BAR_BORDER_DISTANCE_COUNT]
+){
+	return bucket_start[ status_bar_window_get_zone( item->alignment ) ][ item->distance ] + item->rank;
+}
+
+//counting sort of items, in place: each item goes after every item with the same zone and a lower distance,
+//and after the items with its same zone and distance that were added before it (i.e. with a lower rank)
+void status_bar_window_layout_finish( status_bar_window_layout_t *status_bar_window_layout ){
+	uint16_t bucket_start[STATUS_BAR_WINDOW_ZONE_COUNT][STATUS_BAR_BORDER_DISTANCE_COUNT];
+	uint16_t position = 0;
+	
+	for( int zone = 0; zone < STATUS_BAR_WINDOW_ZONE_COUNT; zone++ ){
+		status_bar_window_layout->zone_start[zone] = position;
+		
+		for( int distance = 0; distance < STATUS_BAR_BORDER_DISTANCE_COUNT; distance++ ){
+			bucket_start[zone][distance] = position;
+			position += status_bar_window_layout->bucket_count[zone][distance];
+		}
+		
+		status_bar_window_layout->zone_count[zone] = position - status_bar_window_layout->zone_start[zone];
+	}
+	
+	//system items must point to their new position
+	for( int system_item = 0; system_item < STATUS_BAR_WINDOW_SYSTEM_ITEM_COUNT; system_item++ ){
+		status_bar_window_layout_item_t *item = status_bar_window_layout->system_items[system_item];
+		if( NULL != item ){
+			status_bar_window_layout->system_items[system_item] =
+				&( status_bar_window_layout->items[ status_bar_window_layout_item_get_position( item, bucket_start ) ] );
+		}
+	}
+	
+	//every swap puts one item in its final position
+	for( size_t i = 0; i < status_bar_window_layout->item_count; i++ ){
+		status_bar_window_layout_item_t *item = &( status_bar_window_layout->items[i] );
+		size_t item_position;
+		while( ( item_position = status_bar_window_layout_item_get_position( item, bucket_start ) ) != i ){
+			status_bar_window_layout_item_t swapped_item = status_bar_window_layout->items[item_position];
+			status_bar_window_layout->items[item_position] = *item;
+			*item = swapped_item;
+		}
+	}
 	
-	free( status_bar_window_layout );
+	status_bar_window_layout->is_display_list_valid = false;
 }
 
 
-bool status_bar_window_layout_add_item(		//returns true if successfully added, false if item wouldn't fit
+bool status_bar_window_layout_update_item(		//returns true if item was updated in place, false if layout must be rebuilt
 	status_bar_window_layout_t *status_bar_window_layout,
-	GTextAlignment alignment,
-	status_bar_border_distance_t distance,
-	status_bar_window_layout_item_parts_t item_parts
+	status_bar_window_layout_item_t *item
 ){
-	
-	
-	uint8_t *curr_side_width;
-	status_bar_window_layout_item_t **curr_side_next;
-	status_bar_window_layout_item_t ***curr_side_last_next_ptr;
-	status_bar_border_distance_t *curr_side_max_distance;
-	switch( alignment ){
-	  case GTextAlignmentLeft:
-		curr_side_width = &(status_bar_window_layout->left_width);
-		curr_side_next = &(status_bar_window_layout->left_first);
-		curr_side_last_next_ptr = &(status_bar_window_layout->left_last_next_ptr);
-		curr_side_max_distance = &(status_bar_window_layout->left_max_distance);
-		break;
-		
-	  case GTextAlignmentRight:
-		curr_side_width = &(status_bar_window_layout->right_width);
-		curr_side_next = &(status_bar_window_layout->right_first);
-		curr_side_last_next_ptr = &(status_bar_window_layout->right_last_next_ptr);
-		curr_side_max_distance = &(status_bar_window_layout->right_max_distance);
-		break;
-		
-	  case GTextAlignmentCenter:
-		curr_side_width = &(status_bar_window_layout->center_width);
-		curr_side_next = &(status_bar_window_layout->center_first);
-		curr_side_last_next_ptr = &(status_bar_window_layout->center_last_next_ptr);
-		curr_side_max_distance = &(status_bar_window_layout->center_max_distance);
-		break;
-
-	  default:
-		//this should't happen, but if it does, abort operation
+	uint8_t *curr_side_width = status_bar_window_layout_get_side_width( status_bar_window_layout, item->alignment );
+	if( NULL == curr_side_width ){
 		return false;
 	}
-
-	status_bar_window_layout_item_t *item = status_bar_window_layout_item_create( alignment, distance, item_parts );
-
-	*curr_side_width += item->width;
-	bool should_abort = false;
 	
-	if( status_bar_window_layout->center_width == 0){	// [Left      ...       Right]
-		if( 
-			status_bar_window_layout->left_width + STATUS_BAR_ITEM_DISTANCE + status_bar_window_layout->right_width >
-			STATUS_BAR_WINDOW_WIDTH
-		){
-			should_abort = true;
-		}
-			
-	} else {											// [Left ... Center ... Right]
-		
-		if(
-			( alignment != GTextAlignmentRight ) &&		// [Left ... Cen|            ]
-			(
-				2 * ( status_bar_window_layout->left_width + STATUS_BAR_ITEM_DISTANCE ) + status_bar_window_layout->center_width >
-				STATUS_BAR_WINDOW_WIDTH
-			)
-		){
-			should_abort = true;
-			
-		} else if(
-			( alignment != GTextAlignmentLeft ) &&		// [            |er ... Right]
-			(
-				status_bar_window_layout->center_width +  2 * ( STATUS_BAR_ITEM_DISTANCE + status_bar_window_layout->right_width ) >
-				STATUS_BAR_WINDOW_WIDTH
-			)
-		){
-			should_abort = true;
-		}
+	//fixed size texts never move, and are drawn straight from their buffer (so neither widths nor display list change)
+	if( item->is_text_size_fixed && NULL == item->icon ){
+		return true;
+	}
+	
+	uint8_t old_width = item->width;
+	status_bar_window_layout_item_update_width( item );
+	status_bar_window_layout->is_display_list_valid = false;
+	
+	*curr_side_width = *curr_side_width - old_width + item->width;
+	
+	if( item->width > old_width ){		//if item grew, make sure it still fits
+		return status_bar_window_layout_fits( status_bar_window_layout, item->alignment );
 		
+	} else if( item->width < old_width ){	//if item shrank, some previously rejected item might fit now
+		return !status_bar_window_layout->has_rejected_items;
 	}
 	
-	if( should_abort ){
-		*curr_side_width -= item->width;
-		status_bar_window_layout_item_destroy( item );
-		return false;
+	return true;
+}
+	
+
+void status_bar_window_flush_invalidation( status_bar_window_t *status_bar_window ){
+	if( NULL != status_bar_window->invalidation_timer ){
+		app_timer_cancel( status_bar_window->invalidation_timer );
+		status_bar_window->invalidation_timer = NULL;
 	}
 	
-	if( distance >= *curr_side_max_distance ){	//quick way of finding the end of layout in O(1) time		
-		curr_side_next = *curr_side_last_next_ptr;
-		*curr_side_max_distance = distance;
-		
-	} else {									//finding position in the middle of the layout is still O(N)
-		while( NULL != *curr_side_next ){
-			if( distance < (*curr_side_next)->distance ){
-				break;
-			} else {
-				curr_side_next = &( (*curr_side_next)->next );
-			}
-		}
+	status_bar_window->last_flush_ms = status_bar_stats_get_time_ms();
+	layer_mark_dirty( status_bar_window->layer_status_bar );
+}
+
+static void status_bar_window_invalidation_timer_callback( void *data ){
+	status_bar_window_t *status_bar_window = data;
+	
+	status_bar_window->invalidation_timer = NULL;
+	status_bar_window_flush_invalidation( status_bar_window );
+}
 
+//every invalidation goes through here: redraws right away if the frame interval has passed, or once it does
+static void status_bar_window_schedule_redraw( status_bar_window_t *status_bar_window ){
+	if( NULL != status_bar_window->invalidation_timer ){		//a redraw is already on its way
+		return;
 	}
 	
-	//remember who comes after item (if there's no next item, remember it became the new last)
-	if(	NULL != *curr_side_next ){
-		item->next = *curr_side_next;
+	uint32_t elapsed_ms = status_bar_stats_get_time_ms() - status_bar_window->last_flush_ms;
+	if( elapsed_ms >= status_bar_window->invalidation_interval_ms ){
+		status_bar_window_flush_invalidation( status_bar_window );
 	} else {
-		*curr_side_last_next_ptr = &(item->next);
+		status_bar_window->invalidation_timer = app_timer_register(
+			status_bar_window->invalidation_interval_ms - elapsed_ms,
+			status_bar_window_invalidation_timer_callback,
+			status_bar_window
+		);
 	}
+}
+
+void status_bar_window_mark_layout_dirty( status_bar_window_t *status_bar_window ){
+	status_bar_window->is_layout_dirty = true;
+	status_bar_window->is_frame_cache_valid = false;
+	status_bar_window_schedule_redraw( status_bar_window );
+}
 
-	*curr_side_next = item;
+//updates a single item of the current layout, or falls back to rebuilding the layout if that's not possible
+static void status_bar_window_mark_layout_item_dirty( status_bar_window_t *status_bar_window, status_bar_window_layout_item_t *item ){
+	status_bar_window->is_frame_cache_valid = false;
 	
-	return true;
+	if( 
+		!status_bar_window->is_layout_dirty &&
+		( NULL != item ) &&
+		status_bar_window_layout_update_item( status_bar_window->layout, item )
+	){
+		//keep the layout (the whole window is redrawn either way, so an in-place update saves the layout rebuild, not pixels)
+		status_bar_window_schedule_redraw( status_bar_window );
+	} else {
+		status_bar_window_mark_layout_dirty( status_bar_window );
+	}
 }
+
+void status_bar_window_mark_system_item_dirty( status_bar_window_t *status_bar_window, status_bar_window_system_item_t system_item ){
+	if( status_bar_window->is_layout_dirty ){		//layout will be built from scratch anyway
+		status_bar_window_mark_layout_dirty( status_bar_window );
+		return;
+	}
 	
+	status_bar_window_mark_layout_item_dirty( status_bar_window, status_bar_window->layout->system_items[system_item] );
+}
 
-void status_bar_window_mark_layout_dirty( status_bar_window_t *status_bar_window ){
-	if( NULL != status_bar_window->layout ){
-		status_bar_window_layout_destroy( status_bar_window->layout );
-		status_bar_window->layout = NULL;
+void status_bar_window_mark_item_dirty( status_bar_window_t *status_bar_window, status_bar_item_t *source ){
+	status_bar_window_layout_t *status_bar_window_layout = status_bar_window->layout;
+	if( status_bar_window->is_layout_dirty ){		//layout will be built from scratch anyway
+		status_bar_window_mark_layout_dirty( status_bar_window );
+		return;
 	}
 	
-	layer_mark_dirty( status_bar_window->layer_status_bar );
+	//find the layout item built from source
+	status_bar_window_zone_t zone = status_bar_window_get_zone( status_bar_item_get_alignment(source) );
+	status_bar_window_layout_item_t *item = NULL;
+	for(
+		size_t i = status_bar_window_layout->zone_start[zone];
+		i < status_bar_window_layout->zone_start[zone] + status_bar_window_layout->zone_count[zone];
+		i++
+	){
+		if( status_bar_window_layout->items[i].source == source ){
+			item = &( status_bar_window_layout->items[i] );
+			break;
+		}
+	}
+	
+	if( NULL == item ){
+		if( status_bar_window_layout->has_rejected_items ){	//item might have been left out for not fitting
+			status_bar_window_mark_layout_dirty( status_bar_window );
+		}
+		return;											//otherwise, item isn't currently shown
+	}
+	
+	item->text = status_bar_item_get_text(source);
+	status_bar_window_mark_layout_item_dirty( status_bar_window, item );
 }
 
 
 void status_bar_window_build_layout( status_bar_window_t *status_bar_window ){
-	if( NULL != status_bar_window->layout ) return;
+	if( !status_bar_window->is_layout_dirty ) return;
+	
+	STATUS_BAR_STATS_TIMER_START( timer );
+	STATUS_BAR_PROFILE_START( sample );
+	status_bar_window->rebuild_count++;
+	
+	//reuse previous layout, unless it can't hold every system item and shown catalog item
+	size_t item_capacity = STATUS_BAR_WINDOW_SYSTEM_ITEM_COUNT + status_bar_item_catalog_get_shown_count();
+	if( NULL != status_bar_window->layout && status_bar_window->layout->item_capacity < item_capacity ){
+		status_bar_window_layout_destroy( status_bar_window->layout );
+		status_bar_window->layout = NULL;
+	}
 	
-	status_bar_window->layout = status_bar_window_layout_create();
+	if( NULL == status_bar_window->layout ){
+		status_bar_window->layout = status_bar_window_layout_create( item_capacity );
+	} else {
+		status_bar_window_layout_reset( status_bar_window->layout );
+	}
+	status_bar_window->is_layout_dirty = false;
 
 	if( !status_bar_window->hide_time ){
 		// current time
-		status_bar_window_layout_add_item(
+		status_bar_window->layout->system_items[STATUS_BAR_WINDOW_SYSTEM_ITEM_TIME] = status_bar_window_layout_add_item(
 			status_bar_window->layout, GTextAlignmentCenter, STATUS_BAR_BORDER_DISTANCE_SYSTEM_TEXT,
 			(status_bar_window_layout_item_parts_t){
 				.distance_offset = STATUS_BAR_CLOCK_TEXT_DISTANCE_OFFSET,
 				
 				.text = s_status_bar_window_globals->curr_time_text_buffer,
-				.text_font = s_status_bar_window_globals->res_gothic_18_bold
-			}
+				.text_font = s_status_bar_window_globals->res_gothic_18_bold,
+				
+				.text_fixed_size = status_bar_window->show_seconds ? status_bar_window_get_seconds_clock_size() : GSize(0, 0)
+			},
+			NULL
 		);
 		
 		if( !clock_is_24h_style() ){
 			// AM/PM
-			status_bar_window_layout_add_item(
+			status_bar_window->layout->system_items[STATUS_BAR_WINDOW_SYSTEM_ITEM_TIME_SUFFIX] = status_bar_window_layout_add_item(
 				status_bar_window->layout, GTextAlignmentCenter, STATUS_BAR_BORDER_DISTANCE_SYSTEM_TEXT,
 				(status_bar_window_layout_item_parts_t){
 					.distance_offset = STATUS_BAR_AM_PM_TEXT_DISTANCE_OFFSET,
 					
 					.text = s_status_bar_window_globals->curr_time_suffix_text_buffer,
 					.text_font = s_status_bar_window_globals->res_gothic_14
-				}
+				},
+				NULL
 			);
 		}
 	}
 	
 	// Battery Icon
-	status_bar_window_layout_add_item(
+	status_bar_window->layout->system_items[STATUS_BAR_WINDOW_SYSTEM_ITEM_BATTERY_ICON] = status_bar_window_layout_add_item(
 		status_bar_window->layout, GTextAlignmentRight, STATUS_BAR_BORDER_DISTANCE_SYSTEM_ICON,
 		(status_bar_window_layout_item_parts_t){
 			.distance_offset = STATUS_BAR_BORDER_DISTANCE_OFFSET,
 			
-			.icon = s_status_bar_window_globals->res_icon_battery,
+			.icon = status_bar_window_get_resource( STATUS_BAR_WINDOW_RESOURCE_ICON_BATTERY ),
 			
 			.battery_state = &(s_status_bar_window_globals->watch_battery_state),
 			.battery_full_missing_percent = STATUS_BAR_WATCH_FULL_MISSING_PERCENT,
@@ -487,61 +1330,72 @@ void status_bar_window_build_layout( status_bar_window_t *status_bar_window ){
 				STATUS_BAR_WATCH_BATTERY_X,
 				STATUS_BAR_WATCH_BATTERY_Y
 			)
-		}
+		},
+		NULL
 	);
 	
 	
-	// Phone Icon
+	// Phone Icon (its battery is only drawn once the phone has sent its charge state)
 	if( s_status_bar_window_globals->is_connected_to_phone ){
-		status_bar_window_layout_add_item(
+		status_bar_window_layout_item_parts_t phone_parts = {
+			.distance_offset = STATUS_BAR_BORDER_DISTANCE_OFFSET,
+			
+			.icon = status_bar_window_get_resource( STATUS_BAR_WINDOW_RESOURCE_ICON_PHONE )
+		};
+		if( s_status_bar_window_phone_battery.is_known ){
+			phone_parts.battery_state = &(s_status_bar_window_phone_battery.state);
+			phone_parts.battery_full_missing_percent = STATUS_BAR_PHONE_FULL_MISSING_PERCENT;
+			phone_parts.battery_empty_missing_percent = STATUS_BAR_PHONE_EMPTY_MISSING_PERCENT;
+			phone_parts.battery_icon_origin = GPoint(
+				STATUS_BAR_PHONE_BATTERY_X,
+				STATUS_BAR_PHONE_BATTERY_Y
+			);
+		}
+		
+		status_bar_window->layout->system_items[STATUS_BAR_WINDOW_SYSTEM_ITEM_PHONE_ICON] = status_bar_window_layout_add_item(
 			status_bar_window->layout, GTextAlignmentLeft, STATUS_BAR_BORDER_DISTANCE_SYSTEM_ICON,
-			(status_bar_window_layout_item_parts_t){
-				.distance_offset = STATUS_BAR_BORDER_DISTANCE_OFFSET,
-				
-				.icon = s_status_bar_window_globals->res_icon_phone,
-				
-				/*
-				.battery_state = &(s_status_bar_window_globals->phone_battery_state),
-				.battery_full_missing_percent = STATUS_BAR_PHONE_FULL_MISSING_PERCENT,
-				.battery_empty_missing_percent = STATUS_BAR_PHONE_EMPTY_MISSING_PERCENT,
-				.battery_icon_origin = GPoint(
-					STATUS_BAR_PHONE_BATTERY_X,
-					STATUS_BAR_PHONE_BATTERY_Y
-				),
-				*/
-			}
+			phone_parts,
+			NULL
 		);
 	}
 	
 	
-	// Catalog items
+	// Catalog items (only the shown ones, which the catalog keeps track of)
 	status_bar_item_t *item;
-	for( item = status_bar_item_catalog_get_first(); NULL != item; item = status_bar_item_get_next(item) ){
-		if( 
-			( NULL != status_bar_item_get_icon(item) ) &&
-			( !status_bar_item_get_requires_phone_connection(item) || s_status_bar_window_globals->is_connected_to_phone )
-		){
-			status_bar_window_layout_add_item(
-				status_bar_window->layout, status_bar_item_get_alignment(item), status_bar_item_get_distance(item),
-				(status_bar_window_layout_item_parts_t){
-					.icon = status_bar_item_get_icon(item),
-					.text = status_bar_item_get_text(item),
-					.text_font = s_status_bar_window_globals->res_gothic_14
-				}
-			);
+	for( item = status_bar_item_catalog_get_first_shown(); NULL != item; item = status_bar_item_catalog_get_next_shown(item) ){
+		GBitmap *icon = status_bar_item_use_icon(item);		//reloads icon, if it was evicted from the icon cache
+		if( NULL == icon ){
+			continue;
 		}
+		
+		status_bar_window_layout_add_item(
+			status_bar_window->layout, status_bar_item_get_alignment(item), status_bar_item_get_distance(item),
+			(status_bar_window_layout_item_parts_t){
+				.icon = icon,
+				.text = status_bar_item_get_text(item),
+				.text_font = s_status_bar_window_globals->res_gothic_14
+			},
+			item
+		);
 	}
 	
 	
 	// Battery charge percent text
-	status_bar_window_layout_add_item( status_bar_window->layout, GTextAlignmentRight, STATUS_BAR_BORDER_DISTANCE_SYSTEM_TEXT,
+	status_bar_window->layout->system_items[STATUS_BAR_WINDOW_SYSTEM_ITEM_BATTERY_TEXT] = status_bar_window_layout_add_item(
+		status_bar_window->layout, GTextAlignmentRight, STATUS_BAR_BORDER_DISTANCE_SYSTEM_TEXT,
 		(status_bar_window_layout_item_parts_t){
 			.distance_offset = STATUS_BAR_BATTERY_TEXT_DISTANCE_OFFSET,
 			
 			.text =  s_status_bar_window_globals->watch_battery_text_buffer,
 			.text_font = s_status_bar_window_globals->res_gothic_18_bold
-		}
+		},
+		NULL
 	);
+	
+	status_bar_window_layout_finish( status_bar_window->layout );
+	
+	STATUS_BAR_STATS_TIMER_STOP( timer, STATUS_BAR_STATS_EVENT_BUILD_LAYOUT );
+	STATUS_BAR_PROFILE_STOP( sample, STATUS_BAR_PROFILE_POINT_BUILD_LAYOUT );
 }
 
 
@@ -549,59 +1403,295 @@ void status_bar_window_build_layout( status_bar_window_t *status_bar_window ){
 // Rendering functions //
 //---------------------//
 
+static void status_bar_window_frame_cache_destroy( status_bar_window_t *status_bar_window ){
+	if( NULL == status_bar_window->frame_cache ){
+		return;
+	}
+	
+	STATUS_BAR_STATS_HEAP_UNTRACK( STATUS_BAR_STATS_HEAP_WINDOW, status_bar_stats_get_bitmap_bytes( status_bar_window->frame_cache ) );
+	gbitmap_destroy( status_bar_window->frame_cache );
+	status_bar_window->frame_cache = NULL;
+}
+
+//copies the status bar's rows of the frame buffer into the frame cache
+static void status_bar_window_capture_frame_cache( status_bar_window_t *status_bar_window, GContext *ctx ){
+	GBitmap *frame_buffer = graphics_capture_frame_buffer( ctx );
+	if( NULL == frame_buffer ){
+		return;
+	}
+	
+	if( NULL == status_bar_window->frame_cache ){
+		#ifdef PBL_ROUND
+			GBitmapFormat format = GBitmapFormat8Bit;
+		#else
+			GBitmapFormat format = gbitmap_get_format( frame_buffer );
+		#endif
+		status_bar_window->frame_cache = gbitmap_create_blank(
+			GSize( STATUS_BAR_WINDOW_WIDTH, CUSTOM_STATUS_BAR_LAYER_HEIGHT ), format
+		);
+		if( NULL != status_bar_window->frame_cache ){
+			STATUS_BAR_STATS_HEAP_TRACK( STATUS_BAR_STATS_HEAP_WINDOW, status_bar_stats_get_bitmap_bytes( status_bar_window->frame_cache ) );
+		}
+	}
+	
+	if( NULL != status_bar_window->frame_cache ){
+		uint8_t *cache_data = gbitmap_get_data( status_bar_window->frame_cache );
+		uint16_t cache_bytes_per_row = gbitmap_get_bytes_per_row( status_bar_window->frame_cache );
+		
+		for( int y = 0; y < CUSTOM_STATUS_BAR_LAYER_HEIGHT; y++ ){
+			uint8_t *cache_row = cache_data + y * cache_bytes_per_row;
+			
+			#ifdef PBL_ROUND
+				//round displays have a different width for each row
+				GBitmapDataRowInfo row_info = gbitmap_get_data_row_info( frame_buffer, y );
+				int min_x = ( row_info.min_x > 0 ) ? row_info.min_x : 0;
+				int max_x = ( row_info.max_x < STATUS_BAR_WINDOW_WIDTH - 1 ) ? row_info.max_x : STATUS_BAR_WINDOW_WIDTH - 1;
+				if( max_x >= min_x ){
+					memcpy( cache_row + min_x, row_info.data + min_x, max_x - min_x + 1 );
+				}
+			#else
+				uint16_t frame_bytes_per_row = gbitmap_get_bytes_per_row( frame_buffer );
+				memcpy(
+					cache_row,
+					gbitmap_get_data( frame_buffer ) + y * frame_bytes_per_row,
+					( cache_bytes_per_row < frame_bytes_per_row ) ? cache_bytes_per_row : frame_bytes_per_row
+				);
+			#endif
+		}
+		
+		status_bar_window->is_frame_cache_valid = true;
+	}
+	
+	graphics_release_frame_buffer( ctx, frame_buffer );
+}
+
+
+//builds the layout if it's dirty, then replays the display lists of all zones
+//(a single layer, as Pebble redraws the whole window whenever any layer is dirty anyway)
 static void render_status_bar_layer( struct Layer *layer, GContext *ctx ) {	
+	(void)layer;
 	status_bar_window_t *status_bar_window = get_current_status_bar_window();
-	int8_t offset_x;
-	status_bar_window_layout_item_t *item;	
+	status_bar_window->redraw_count++;
 	
 	//build layout, if it's been marked as dirty
-	status_bar_window_build_layout( status_bar_window );
+	if( status_bar_window->is_layout_dirty ){
+		status_bar_window_build_layout( status_bar_window );
+	}
 	
-	//render left items
-	offset_x = 0;
-	for( item = status_bar_window->layout->left_first; NULL != item; item = item->next ){
-		offset_x = status_bar_window_layout_item_render( item, ctx, offset_x );	
+	//nothing changed since last capture, so just copy the status bar back from the frame cache
+	if( status_bar_window->is_frame_cache_enabled && status_bar_window->is_frame_cache_valid ){
+		graphics_context_set_compositing_mode( ctx, GCompOpAssign );
+		graphics_draw_bitmap_in_rect(
+			ctx, status_bar_window->frame_cache,
+			GRect( 0, 0, STATUS_BAR_WINDOW_WIDTH, CUSTOM_STATUS_BAR_LAYER_HEIGHT )
+		);
+		return;
 	}
 	
-	//render center items
-	offset_x = ( STATUS_BAR_WINDOW_WIDTH - status_bar_window->layout->center_width ) / 2;
-	for( item =  status_bar_window->layout->center_first; NULL != item; item = item->next ){
-		offset_x = status_bar_window_layout_item_render( item, ctx, offset_x );	
+	STATUS_BAR_STATS_TIMER_START( timer );
+	
+	for( int zone = 0; zone < STATUS_BAR_WINDOW_ZONE_COUNT; zone++ ){
+		status_bar_window_layout_render_zone( status_bar_window->layout, zone, ctx );
 	}
 	
-	//render right items
-	offset_x = 0;
-	for( item =  status_bar_window->layout->right_first; NULL != item; item = item->next ){
-		offset_x = status_bar_window_layout_item_render( item, ctx, offset_x );
+	//the whole status bar is in the frame buffer by now
+	//(only capture it when it's at the top of the screen, and not e.g. in the middle of a window transition)
+	if( status_bar_window->is_frame_cache_enabled ){
+		GPoint screen_origin = layer_convert_point_to_screen( status_bar_window->layer_status_bar, GPointZero );
+		if( screen_origin.x == 0 && screen_origin.y == 0 ){
+			status_bar_window_capture_frame_cache( status_bar_window, ctx );
+		}
 	}
+	
+	STATUS_BAR_STATS_TIMER_STOP( timer, STATUS_BAR_STATS_EVENT_RENDER );
 }
 
 
-//------------------//
-// Service Handlers //
-//------------------//
+//---------------//
+// Phone Battery //
+//---------------//
+
+static void status_bar_window_phone_battery_cancel_timer(void){
+	if( NULL != s_status_bar_window_phone_battery.apply_timer ){
+		app_timer_cancel( s_status_bar_window_phone_battery.apply_timer );
+		s_status_bar_window_phone_battery.apply_timer = NULL;
+	}
+}
 
+//forgets the phone's charge state, and any update still pending (e.g. when the phone disconnects)
+static void status_bar_window_phone_battery_reset(void){
+	status_bar_window_phone_battery_cancel_timer();
+	s_status_bar_window_phone_battery.has_pending_value = false;
+	s_status_bar_window_phone_battery.is_known = false;
+}
 
-static void status_bar_window_tick_handler(struct tm *tick_time, TimeUnits units_changed ){
+//decodes the pending update, and redraws the phone icon if its charge state changed
+static void status_bar_window_phone_battery_apply(void){
+	uint8_t value = s_status_bar_window_phone_battery.pending_value;
+	s_status_bar_window_phone_battery.has_pending_value = false;
+	s_status_bar_window_phone_battery.last_apply_ms = status_bar_stats_get_time_ms();
+	
+	BatteryChargeState state = {
+		.charge_percent = ( value & STATUS_BAR_PHONE_BATTERY_LEVEL_MASK ) * STATUS_BAR_BATTERY_CHARGE_STEP,
+		.is_charging = ( 0 != ( value & STATUS_BAR_PHONE_BATTERY_CHARGING_FLAG ) )
+	};
+	if(
+		s_status_bar_window_phone_battery.is_known &&
+		( s_status_bar_window_phone_battery.state.charge_percent == state.charge_percent ) &&
+		( s_status_bar_window_phone_battery.state.is_charging == state.is_charging )
+	){
+		STATUS_BAR_STATS_INCREMENT( STATUS_BAR_STATS_COUNTER_SUPPRESSED_PHONE_BATTERY );
+		return;
+	}
+	
+	bool was_known = s_status_bar_window_phone_battery.is_known;
+	s_status_bar_window_phone_battery.state = state;
+	s_status_bar_window_phone_battery.is_known = true;
 	
-	if( clock_is_24h_style() ){
-		strftime( s_status_bar_window_globals->curr_time_text_buffer, STATUS_BAR_TIME_TEXT_BUFFER_SIZE, "%H:%M", tick_time );
+	//phone icon reads the charge state directly, but only gets a battery once it's known (which needs a rebuild)
+	status_bar_window_t *status_bar_window = get_current_status_bar_window();
+	if( NULL == status_bar_window ){
+		return;
+	} else if( !was_known ){
+		status_bar_window_mark_layout_dirty( status_bar_window );
 	} else {
-		strftime( s_status_bar_window_globals->curr_time_text_buffer, STATUS_BAR_TIME_TEXT_BUFFER_SIZE, "%I:%M", tick_time );
-		strftime( s_status_bar_window_globals->curr_time_suffix_text_buffer, STATUS_BAR_TIME_SUFFIX_TEXT_BUFFER_SIZE, "%p", tick_time );
+		status_bar_window_mark_system_item_dirty( status_bar_window, STATUS_BAR_WINDOW_SYSTEM_ITEM_PHONE_ICON );
+	}
+}
+
+static void status_bar_window_phone_battery_timer_callback( void *data ){
+	(void)data;
+	s_status_bar_window_phone_battery.apply_timer = NULL;
+	status_bar_window_phone_battery_apply();
+}
+
+//returns the tuple's value, whatever integer width the phone used
+static uint32_t status_bar_window_get_tuple_uint( Tuple *tuple ){
+	switch( tuple->length ){
+	  case 1:
+		return tuple->value->uint8;
+	  case 2:
+		return tuple->value->uint16;
+	  default:
+		return tuple->value->uint32;
+	}
+}
+
+bool status_bar_window_handle_app_message( DictionaryIterator *iterator ){
+	Tuple *tuple = dict_find( iterator, MESSAGE_KEY_STATUS_BAR_PHONE_BATTERY );
+	if( NULL == tuple ){
+		return false;
+	}
+	
+	uint32_t value = status_bar_window_get_tuple_uint( tuple );
+	if(
+		( value & ~( STATUS_BAR_PHONE_BATTERY_CHARGING_FLAG | STATUS_BAR_PHONE_BATTERY_LEVEL_MASK ) ) ||
+		( ( value & STATUS_BAR_PHONE_BATTERY_LEVEL_MASK ) >= STATUS_BAR_BATTERY_CHARGE_LEVELS )
+	){
+		//malformed update, ignore it
+		return true;
 	}
 	
-	//strip leading zero, since both %H and %I generate stuff like "09"
-	if( s_status_bar_window_globals->curr_time_text_buffer[0] == '0' ){
-		memmove(
-			s_status_bar_window_globals->curr_time_text_buffer,
-			s_status_bar_window_globals->curr_time_text_buffer + 1,
-			STATUS_BAR_TIME_TEXT_BUFFER_SIZE-1
+	if( s_status_bar_window_phone_battery.has_pending_value ){
+		STATUS_BAR_STATS_INCREMENT( STATUS_BAR_STATS_COUNTER_COALESCED_PHONE_BATTERY );
+	}
+	s_status_bar_window_phone_battery.pending_value = value;
+	s_status_bar_window_phone_battery.has_pending_value = true;
+	
+	if( NULL != s_status_bar_window_phone_battery.apply_timer ){		//pending update will be applied when the timer fires
+		return true;
+	}
+	
+	uint32_t elapsed_ms = status_bar_stats_get_time_ms() - s_status_bar_window_phone_battery.last_apply_ms;
+	if( elapsed_ms >= s_status_bar_window_phone_battery.interval_ms ){
+		status_bar_window_phone_battery_apply();
+	} else {
+		s_status_bar_window_phone_battery.apply_timer = app_timer_register(
+			s_status_bar_window_phone_battery.interval_ms - elapsed_ms,
+			status_bar_window_phone_battery_timer_callback,
+			NULL
 		);
 	}
 	
+	return true;
+}
+
+void status_bar_window_set_phone_battery_interval( uint32_t interval_ms ){
+	s_status_bar_window_phone_battery.interval_ms = interval_ms;
+}
+
+
+//------------------//
+// Service Handlers //
+//------------------//
+
+
+//writes two digits, returns the position right after them
+static char *status_bar_window_format_two_digits( char *c, int value ){
+	*c++ = '0' + value / 10;
+	*c++ = '0' + value % 10;
+	return c;
+}
+
+//writes the clock as "h:mm" (or "h:mm:ss"), with no leading zero, and its suffix ("AM"/"PM", empty in 24h style)
+static void status_bar_window_format_time( char *time_text, char *time_suffix_text, const struct tm *tick_time, bool is_24h_style, bool show_seconds ){
+	int hour = tick_time->tm_hour;
+	if( is_24h_style ){
+		time_suffix_text[0] = '\0';
+	} else {
+		memcpy( time_suffix_text, ( hour < 12 ) ? "AM" : "PM", STATUS_BAR_TIME_SUFFIX_TEXT_BUFFER_SIZE );
+		hour = ( hour % 12 == 0 ) ? 12 : hour % 12;
+	}
+	
+	char *c = time_text;
+	if( hour >= 10 ){
+		*c++ = '0' + hour / 10;
+	}
+	*c++ = '0' + hour % 10;
+	*c++ = ':';
+	c = status_bar_window_format_two_digits( c, tick_time->tm_min );
+	if( show_seconds ){
+		*c++ = ':';
+		c = status_bar_window_format_two_digits( c, tick_time->tm_sec );
+	}
+	*c = '\0';
+}
+
+//returns the units the status bar's own clock needs ticks for
+static TimeUnits status_bar_window_get_tick_units( status_bar_window_t *status_bar_window ){
+	return status_bar_window->show_seconds ? STATUS_BAR_WINDOW_TICK_UNITS_SECONDS : STATUS_BAR_WINDOW_TICK_UNITS;
+}
+
+static void status_bar_window_tick_handler( struct tm *tick_time ){
+	STATUS_BAR_STATS_TIMER_START( timer );
+	STATUS_BAR_PROFILE_START( sample );
 	status_bar_window_t *status_bar_window = get_current_status_bar_window();
-	status_bar_window_mark_layout_dirty( status_bar_window );
+	char time_text[STATUS_BAR_TIME_TEXT_BUFFER_SIZE];
+	char time_suffix_text[STATUS_BAR_TIME_SUFFIX_TEXT_BUFFER_SIZE];
+	
+	status_bar_window_format_time( time_text, time_suffix_text, tick_time, clock_is_24h_style(), status_bar_window->show_seconds );
+	
+	//only the clock texts may have changed, so update them in place (if they did change at all)
+	bool is_suppressed = true;
+	
+	if( 0 != strcmp( time_text, s_status_bar_window_globals->curr_time_text_buffer ) ){
+		memcpy( s_status_bar_window_globals->curr_time_text_buffer, time_text, STATUS_BAR_TIME_TEXT_BUFFER_SIZE );
+		status_bar_window_mark_system_item_dirty( status_bar_window, STATUS_BAR_WINDOW_SYSTEM_ITEM_TIME );
+		is_suppressed = false;
+	}
+	
+	if( 0 != strcmp( time_suffix_text, s_status_bar_window_globals->curr_time_suffix_text_buffer ) ){
+		memcpy( s_status_bar_window_globals->curr_time_suffix_text_buffer, time_suffix_text, STATUS_BAR_TIME_SUFFIX_TEXT_BUFFER_SIZE );
+		status_bar_window_mark_system_item_dirty( status_bar_window, STATUS_BAR_WINDOW_SYSTEM_ITEM_TIME_SUFFIX );
+		is_suppressed = false;
+	}
+	
+	if( is_suppressed ){
+		STATUS_BAR_STATS_INCREMENT( STATUS_BAR_STATS_COUNTER_SUPPRESSED_TICK );
+	}
+	
+	STATUS_BAR_STATS_TIMER_STOP( timer, STATUS_BAR_STATS_EVENT_TICK );
+	STATUS_BAR_PROFILE_STOP( sample, STATUS_BAR_PROFILE_POINT_TICK_HANDLER );
 }
 
 static void tick_handler(struct tm *tick_time, TimeUnits units_changed ){
@@ -610,9 +1700,9 @@ static void tick_handler(struct tm *tick_time, TimeUnits units_changed ){
 	//call our tick handler, when necessary
 	if(
 		!status_bar_window->hide_time &&
-		( (units_changed == 0) || (units_changed & STATUS_BAR_WINDOW_TICK_UNITS) )
+		( (units_changed == 0) || (units_changed & status_bar_window_get_tick_units( status_bar_window )) )
 	){
-		status_bar_window_tick_handler(tick_time, units_changed);
+		status_bar_window_tick_handler( tick_time );
 	}
 	
 	//also call user's handler, if appropriate
@@ -626,10 +1716,18 @@ static void tick_handler(struct tm *tick_time, TimeUnits units_changed ){
 
 
 static void pebble_app_connection_handler( bool connected ){
+	STATUS_BAR_STATS_TIMER_START( timer );
+	STATUS_BAR_PROFILE_START( sample );
 	s_status_bar_window_globals->is_connected_to_phone = connected;
+	status_bar_item_catalog_set_is_connected_to_phone( connected );		//icons waiting for a connection may be evicted
+	if( !connected ){
+		status_bar_window_phone_battery_reset();		//phone sends its charge state again once it reconnects
+	}
 	
 	status_bar_window_t *status_bar_window = get_current_status_bar_window();
 	status_bar_window_mark_layout_dirty( status_bar_window );
+	STATUS_BAR_STATS_TIMER_STOP( timer, STATUS_BAR_STATS_EVENT_CONNECTION );
+	STATUS_BAR_PROFILE_STOP( sample, STATUS_BAR_PROFILE_POINT_CONNECTION_HANDLER );
 	
 	//also call user's handler, if appropriate
 	if( NULL != s_status_bar_window_globals->connection_handlers.pebble_app_connection_handler ){
@@ -639,11 +1737,39 @@ static void pebble_app_connection_handler( bool connected ){
 
 
 static void battery_handler( BatteryChargeState charge ){
+	STATUS_BAR_STATS_TIMER_START( timer );
+	STATUS_BAR_PROFILE_START( sample );
+	char battery_text[STATUS_BAR_BATTERY_TEXT_BUFFER_SIZE];
+	snprintf( battery_text, STATUS_BAR_BATTERY_TEXT_BUFFER_SIZE, "%d", charge.charge_percent );
+	
+	//compare what would be on screen before and after this event
+	int battery_area_height = s_status_bar_window_resource_slots[STATUS_BAR_WINDOW_RESOURCE_ICON_CHARGING].size.h;
+	status_bar_window_battery_visual_t old_visual = status_bar_window_get_battery_visual(
+		&(s_status_bar_window_globals->watch_battery_state),
+		STATUS_BAR_WATCH_FULL_MISSING_PERCENT, STATUS_BAR_WATCH_EMPTY_MISSING_PERCENT, battery_area_height
+	);
+	status_bar_window_battery_visual_t new_visual = status_bar_window_get_battery_visual(
+		&charge,
+		STATUS_BAR_WATCH_FULL_MISSING_PERCENT, STATUS_BAR_WATCH_EMPTY_MISSING_PERCENT, battery_area_height
+	);
+	bool is_suppressed = (
+		( old_visual.glyph == new_visual.glyph ) &&
+		( old_visual.missing_height == new_visual.missing_height ) &&
+		( 0 == strcmp( battery_text, s_status_bar_window_globals->watch_battery_text_buffer ) )
+	);
+	
 	s_status_bar_window_globals->watch_battery_state = charge;
-	snprintf( s_status_bar_window_globals->watch_battery_text_buffer, STATUS_BAR_BATTERY_TEXT_BUFFER_SIZE, "%d", charge.charge_percent );
+	memcpy( s_status_bar_window_globals->watch_battery_text_buffer, battery_text, STATUS_BAR_BATTERY_TEXT_BUFFER_SIZE );
 	
-	status_bar_window_t *status_bar_window = get_current_status_bar_window();
-	status_bar_window_mark_layout_dirty( status_bar_window );
+	//battery icon reads the charge state directly, so only the percent text needs to be updated
+	if( is_suppressed ){
+		STATUS_BAR_STATS_INCREMENT( STATUS_BAR_STATS_COUNTER_SUPPRESSED_BATTERY );
+	} else {
+		status_bar_window_t *status_bar_window = get_current_status_bar_window();
+		status_bar_window_mark_system_item_dirty( status_bar_window, STATUS_BAR_WINDOW_SYSTEM_ITEM_BATTERY_TEXT );
+	}
+	STATUS_BAR_STATS_TIMER_STOP( timer, STATUS_BAR_STATS_EVENT_BATTERY );
+	STATUS_BAR_PROFILE_STOP( sample, STATUS_BAR_PROFILE_POINT_BATTERY_HANDLER );
 	
 	//also call user's handler, if appropriate
 	if( NULL != s_status_bar_window_globals->battery_handler ){
@@ -693,6 +1819,11 @@ static void handle_window_unload(Window* window) {
 		status_bar_window_layout_destroy( status_bar_window->layout );
 		status_bar_window->layout = NULL;
 	}
+	status_bar_window->is_layout_dirty = true;
+	
+	//destroy frame cache, if one has been captured
+	status_bar_window_frame_cache_destroy( status_bar_window );
+	status_bar_window->is_frame_cache_valid = false;
 	
 	//destroy window contents	
 	layer_destroy( status_bar_window->layer_status_bar );
@@ -715,9 +1846,9 @@ static void handle_window_appear(Window* window) {
 		}
 		
 	} else {
-		tick_timer_service_subscribe( s_status_bar_window_globals->tick_units | STATUS_BAR_WINDOW_TICK_UNITS, tick_handler );
+		tick_timer_service_subscribe( s_status_bar_window_globals->tick_units | status_bar_window_get_tick_units( status_bar_window ), tick_handler );
 		time_t now = time(NULL);
-		status_bar_window_tick_handler( localtime(&now), 0 );
+		status_bar_window_tick_handler( localtime(&now) );
 	}
 	
 	//setup connection handler (this also marks the current layout as dirty)
@@ -765,21 +1896,34 @@ static void handle_window_disappear(Window* window) {
 //------------------------------//
 
 static status_bar_window_globals_t *status_bar_window_globals_create(void){
-	status_bar_window_globals_t *status_bar_window_globals = malloc( sizeof(*status_bar_window_globals) );
+	status_bar_window_globals_t *status_bar_window_globals = STATUS_BAR_MALLOC( STATUS_BAR_STATS_HEAP_WINDOW, sizeof(*status_bar_window_globals) );
 	
 	status_bar_window_globals->num_windows = 0;
 	status_bar_window_globals->current_window = NULL;
 	
-	// textures
-	status_bar_window_globals->res_icon_phone = gbitmap_create_with_resource(RESOURCE_ID_ICON_STATUS_BAR_PHONE);
-	status_bar_window_globals->res_icon_battery = gbitmap_create_with_resource(RESOURCE_ID_ICON_STATUS_BAR_BATTERY);
-	status_bar_window_globals->res_icon_charging = gbitmap_create_with_resource(RESOURCE_ID_ICON_STATUS_BAR_CHARGING);
-	status_bar_window_globals->res_icon_charging_half = gbitmap_create_with_resource(RESOURCE_ID_ICON_STATUS_BAR_CHARGING_HALF);
-		
-	// fonts
+	// fonts (textures are loaded on first use, see status_bar_window_get_resource)
 	status_bar_window_globals->res_gothic_18_bold = fonts_get_system_font(FONT_KEY_GOTHIC_18_BOLD);
 	status_bar_window_globals->res_gothic_14 = fonts_get_system_font(FONT_KEY_GOTHIC_14);
 	
+	// text measurement cache (all entries initially unused)
+	memset( status_bar_window_globals->text_cache, 0, sizeof(status_bar_window_globals->text_cache) );
+	status_bar_window_globals->text_cache_uses = 0;
+	
+	// glyph advance tables, for system texts
+	status_bar_window_glyph_table_init(
+		&( status_bar_window_globals->glyph_tables[STATUS_BAR_WINDOW_GLYPH_TABLE_GOTHIC_18_BOLD] ), status_bar_window_globals->res_gothic_18_bold
+	);
+	status_bar_window_glyph_table_init(
+		&( status_bar_window_globals->glyph_tables[STATUS_BAR_WINDOW_GLYPH_TABLE_GOTHIC_14] ), status_bar_window_globals->res_gothic_14
+	);
+	
+	// current system status (nothing shown yet)
+	status_bar_window_globals->curr_time_text_buffer[0] = '\0';
+	status_bar_window_globals->curr_time_suffix_text_buffer[0] = '\0';
+	status_bar_window_globals->watch_battery_text_buffer[0] = '\0';
+	status_bar_window_globals->is_connected_to_phone = false;
+	status_bar_window_globals->watch_battery_state = (BatteryChargeState){ 0 };
+	
 	// service handler callbacks
 	status_bar_window_globals->tick_units = 0;
 	status_bar_window_globals->tick_handler = NULL;
@@ -794,12 +1938,7 @@ static status_bar_window_globals_t *status_bar_window_globals_create(void){
 
 
 static void status_bar_window_globals_destroy(status_bar_window_globals_t *status_bar_window_globals){	
-	gbitmap_destroy( status_bar_window_globals->res_icon_battery );
-	gbitmap_destroy( status_bar_window_globals->res_icon_phone );
-	gbitmap_destroy( status_bar_window_globals->res_icon_charging );
-	gbitmap_destroy( status_bar_window_globals->res_icon_charging_half );
-
-	free( status_bar_window_globals );
+	STATUS_BAR_FREE( status_bar_window_globals );
 }
 
 
@@ -808,8 +1947,9 @@ status_bar_window_t *status_bar_window_create( bool hide_time ){
 		s_status_bar_window_globals = status_bar_window_globals_create(); 
 	}
 	s_status_bar_window_globals->num_windows++;
+	status_bar_window_resources_acquire();
 	
-	status_bar_window_t *status_bar_window = malloc( sizeof(*status_bar_window) );
+	status_bar_window_t *status_bar_window = STATUS_BAR_MALLOC( STATUS_BAR_STATS_HEAP_WINDOW, sizeof(*status_bar_window) );
 	
 	//window
 	status_bar_window->window = window_create();
@@ -839,7 +1979,17 @@ status_bar_window_t *status_bar_window_create( bool hide_time ){
 	//internal status
 	status_bar_window->user_data = NULL;
 	status_bar_window->layout = NULL;
+	status_bar_window->is_layout_dirty = true;
+	status_bar_window->is_frame_cache_enabled = false;
+	status_bar_window->frame_cache = NULL;
+	status_bar_window->is_frame_cache_valid = false;
+	status_bar_window->invalidation_interval_ms = STATUS_BAR_INVALIDATION_INTERVAL_MS_DEFAULT;
+	status_bar_window->last_flush_ms = 0;
+	status_bar_window->invalidation_timer = NULL;
+	status_bar_window->rebuild_count = 0;
+	status_bar_window->redraw_count = 0;
 	status_bar_window->hide_time = hide_time;
+	status_bar_window->show_seconds = false;
 	
 	return status_bar_window;
 }
@@ -849,9 +1999,15 @@ void status_bar_window_destroy( status_bar_window_t *status_bar_window ){
 	if( NULL != status_bar_window->layout ){
 		status_bar_window_layout_destroy( status_bar_window->layout );
 	}
+	status_bar_window_frame_cache_destroy( status_bar_window );
+	if( NULL != status_bar_window->invalidation_timer ){
+		app_timer_cancel( status_bar_window->invalidation_timer );
+	}
 	
 	window_destroy( status_bar_window->window );
-	free( status_bar_window );
+	STATUS_BAR_FREE( status_bar_window );
+	
+	status_bar_window_resources_release();
 	
 	if( 0 == --(s_status_bar_window_globals->num_windows) ){
 		status_bar_window_globals_destroy(s_status_bar_window_globals);
@@ -889,6 +2045,54 @@ Layer *status_bar_window_get_body_layer(status_bar_window_t *status_bar_window )
 	return status_bar_window->layer_body;
 }
 
+status_bar_window_layout_t *status_bar_window_get_layout( status_bar_window_t *status_bar_window ){
+	return status_bar_window->layout;
+}
+
+
+void status_bar_window_set_frame_cache_enabled( status_bar_window_t *status_bar_window, bool enabled ){
+	status_bar_window->is_frame_cache_enabled = enabled;
+	status_bar_window->is_frame_cache_valid = false;
+	
+	if( !enabled ){
+		status_bar_window_frame_cache_destroy( status_bar_window );
+	}
+}
+
+
+void status_bar_window_set_invalidation_interval( status_bar_window_t *status_bar_window, uint32_t interval_ms ){
+	status_bar_window->invalidation_interval_ms = interval_ms;
+}
+
+void status_bar_window_set_seconds_enabled( status_bar_window_t *status_bar_window, bool enabled ){
+	if( status_bar_window->show_seconds == enabled ){
+		return;
+	}
+	status_bar_window->show_seconds = enabled;
+	
+	//clock slot changes size (windows that aren't shown are rebuilt once they appear)
+	if( status_bar_window != get_current_status_bar_window() ){
+		status_bar_window->is_layout_dirty = true;
+		return;
+	}
+	status_bar_window_mark_layout_dirty( status_bar_window );
+	
+	//tick with the new units right away
+	if( !status_bar_window->hide_time ){
+		tick_timer_service_subscribe( s_status_bar_window_globals->tick_units | status_bar_window_get_tick_units( status_bar_window ), tick_handler );
+		time_t now = time(NULL);
+		status_bar_window_tick_handler( localtime(&now) );
+	}
+}
+
+uint32_t status_bar_window_get_rebuild_count( status_bar_window_t *status_bar_window ){
+	return status_bar_window->rebuild_count;
+}
+
+uint32_t status_bar_window_get_redraw_count( status_bar_window_t *status_bar_window ){
+	return status_bar_window->redraw_count;
+}
+
 	
 //----------------------------------------//
 // Replacements for core pebble functions //
@@ -924,7 +2128,7 @@ void status_bar_window_tick_timer_service_subscribe( status_bar_window_t *status
 	if( status_bar_window->hide_time ){
 		tick_timer_service_subscribe( tick_units, tick_handler );		
 	} else {
-		tick_timer_service_subscribe( tick_units | STATUS_BAR_WINDOW_TICK_UNITS, tick_handler );
+		tick_timer_service_subscribe( tick_units | status_bar_window_get_tick_units( status_bar_window ), tick_handler );
 	}
 	
 	time_t now = time(NULL);
@@ -938,7 +2142,7 @@ void status_bar_window_tick_timer_service_unsubscribe( status_bar_window_t *stat
 	if( status_bar_window->hide_time ){
 		tick_timer_service_unsubscribe();
 	} else {
-		tick_timer_service_subscribe( STATUS_BAR_WINDOW_TICK_UNITS, tick_handler );
+		tick_timer_service_subscribe( status_bar_window_get_tick_units( status_bar_window ), tick_handler );
 	}
 	
 }
@@ -0,0 +1,175 @@
+#!/usr/bin/env python3
+"""Regression gate for the layout benchmark.
+
+Reads the "status bar bench" lines printed by the host build's bench_layout (see host/bench/bench_layout.c),
+prints how layout building and display list compiling scale with the item count, and compares every
+case against a baseline recorded on a similar machine:
+
+- a case regresses when its fastest round grows by more than --time-tolerance percent and by more than
+  --time-slack ticks (host clock ticks are CPU cycles, so this only means something on the baseline's machine)
+- or when it allocates more than in the baseline (allocations are deterministic)
+- cases missing from the log fail too, new cases are only reported
+
+With --allocs-only, only allocations are compared. --max-scaling also checks the run against itself:
+the ticks per item at the largest item count may be at most that many times the ticks per item at
+--scaling-min-items, which holds on any machine as long as layouts stay linear in their items.
+
+Exits with 1 on any regression, so it can gate a CI run (ctest runs it as bench_layout_gate, with
+--allocs-only and --max-scaling).
+
+Usage: tools/check_layout_benchmark.py --run build/bench_layout --update-baseline host/bench/layout_benchmark_baseline.json
+       tools/check_layout_benchmark.py --run build/bench_layout --baseline host/bench/layout_benchmark_baseline.json
+       tools/check_layout_benchmark.py --run build/bench_layout --baseline host/bench/layout_benchmark_baseline.json --allocs-only --max-scaling 3
+       tools/check_layout_benchmark.py bench.log --baseline host/bench/layout_benchmark_baseline.json [--output results.json]
+"""
+import argparse
+import collections
+import json
+import re
+import subprocess
+import sys
+
+LINE_PATTERN = re.compile(
+	r'status bar bench items=(?P<items>\d+) distances=(?P<distances>\w+) texts=(?P<texts>\w+) '
+	r'alignments=(?P<alignments>\w+) rounds=(?P<rounds>\d+) build_ticks=(?P<build_ticks>\d+) '
+	r'compile_ticks=(?P<compile_ticks>\d+) allocs=(?P<allocs>-?\d+)'
+)
+TIMES = ('build_ticks', 'compile_ticks')
+
+
+def case_name(match):
+	return 'items=%s distances=%s texts=%s alignments=%s' % (
+		match['items'], match['distances'], match['texts'], match['alignments'])
+
+
+def parse_log(lines):
+	results = collections.OrderedDict()
+	for line in lines:
+		match = LINE_PATTERN.search(line)
+		if match is None:
+			continue
+		# a case logged twice (e.g. the benchmark ran again) keeps its latest run
+		results[case_name(match)] = {
+			'items': int(match['items']),
+			'rounds': int(match['rounds']),
+			'build_ticks': int(match['build_ticks']),
+			'compile_ticks': int(match['compile_ticks']),
+			'allocs': int(match['allocs']),
+		}
+	return results
+
+
+def scaling(results):
+	# mean ticks per layout for each item count, over all the distance, text and alignment cases
+	# (times are each case's fastest round)
+	totals = collections.OrderedDict()
+	for result in sorted(results.values(), key=lambda result: result['items']):
+		total = totals.setdefault(result['items'], {'cases': 0, 'build_ticks': 0, 'compile_ticks': 0})
+		total['cases'] += 1
+		for key in TIMES:
+			total[key] += result[key]
+
+	means = collections.OrderedDict()
+	for items, total in totals.items():
+		means[items] = {key: total[key] / total['cases'] for key in TIMES}
+	return means
+
+
+def print_scaling(means):
+	print('%6s %14s %16s %14s' % ('items', 'build/layout', 'compile/layout', 'total/item'))
+	for items, mean in means.items():
+		print('%6d %14.2f %16.2f %14.4f' % (
+			items, mean['build_ticks'], mean['compile_ticks'], (mean['build_ticks'] + mean['compile_ticks']) / items))
+
+
+def check_scaling(means, max_scaling, min_items):
+	# ticks per item at the largest item count, against the smallest count from min_items on (both from this run)
+	counts = [items for items in means if items >= min_items]
+	if len(counts) < 2:
+		return ['scaling: fewer than two item counts from %d items on' % min_items]
+	per_item = {items: (means[items]['build_ticks'] + means[items]['compile_ticks']) / items for items in counts}
+	ratio = per_item[counts[-1]] / per_item[counts[0]]
+	print('scaling: %.2f ticks per item at %d items, %.2f at %d items (ratio %.2f, at most %.2f)' % (
+		per_item[counts[-1]], counts[-1], per_item[counts[0]], counts[0], ratio, max_scaling))
+	if ratio > max_scaling:
+		return ['scaling: ticks per item grew %.2f times from %d to %d items (at most %.2f)' % (
+			ratio, counts[0], counts[-1], max_scaling)]
+	return []
+
+
+def compare(results, baseline, time_tolerance, time_slack, allocs_only):
+	regressions = []
+	for name, expected in baseline.items():
+		result = results.get(name)
+		if result is None:
+			regressions.append('%s: missing from the log' % name)
+			continue
+		for key in () if allocs_only else TIMES:
+			limit = max(expected[key] * (1 + time_tolerance / 100.0), expected[key] + time_slack)
+			if result[key] > limit:
+				regressions.append('%s: %s %d > %d (baseline %d)' % (name, key, result[key], limit, expected[key]))
+		if 0 <= expected['allocs'] < result['allocs']:
+			regressions.append('%s: allocs %d > %d' % (name, result['allocs'], expected['allocs']))
+
+	for name in results:
+		if name not in baseline:
+			print('new case (not in the baseline): %s' % name)
+	return regressions
+
+
+def main():
+	parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+	parser.add_argument('log', nargs='?', type=argparse.FileType('r'), help='output of bench_layout ("-" for stdin)')
+	parser.add_argument('--run', metavar='BINARY', help='run this bench_layout binary instead of reading a log')
+	parser.add_argument('--rounds', type=int, help='rounds per case, for --run')
+	parser.add_argument('--baseline', help='baseline JSON to compare against')
+	parser.add_argument('--update-baseline', metavar='BASELINE', help='write the results as the new baseline')
+	parser.add_argument('--output', help='also write the parsed results as JSON')
+	parser.add_argument('--time-tolerance', type=float, default=25.0, help='allowed time growth, in percent')
+	parser.add_argument('--time-slack', type=int, default=2000, help='time growth always allowed, in clock ticks')
+	parser.add_argument('--allocs-only', action='store_true', help='only compare allocations against the baseline')
+	parser.add_argument('--max-scaling', type=float, help='allowed growth of the ticks per item, from --scaling-min-items to the most items')
+	parser.add_argument('--scaling-min-items', type=int, default=10, help='item count the scaling is measured from')
+	args = parser.parse_args()
+	if (args.log is None) == (args.run is None):
+		parser.error('give either a log or --run')
+
+	if args.run is not None:
+		command = [args.run] + (['--rounds', str(args.rounds)] if args.rounds is not None else [])
+		run = subprocess.run(command, stdout=subprocess.PIPE, universal_newlines=True)
+		if run.returncode != 0:
+			sys.stdout.write(run.stdout)
+			sys.exit('%s exited with %d' % (args.run, run.returncode))
+		lines = run.stdout.splitlines()
+	else:
+		lines = args.log
+
+	results = parse_log(lines)
+	if not results:
+		sys.exit('no "status bar bench" lines in the output')
+	means = scaling(results)
+	print_scaling(means)
+
+	for path in (args.output, args.update_baseline):
+		if path is not None:
+			with open(path, 'w') as output:
+				json.dump(results, output, indent='\t')
+				output.write('\n')
+
+	regressions = []
+	if args.max_scaling is not None:
+		regressions += check_scaling(means, args.max_scaling, args.scaling_min_items)
+	if args.baseline is not None:
+		with open(args.baseline) as baseline_file:
+			baseline = json.load(baseline_file)
+		regressions += compare(results, baseline, args.time_tolerance, args.time_slack, args.allocs_only)
+	for regression in regressions:
+		print('REGRESSION %s' % regression)
+	if regressions:
+		sys.exit(1)
+	if args.baseline is not None:
+		print('%d cases within the baseline%s' % (len(baseline), ' (allocations only)' if args.allocs_only else ''))
+
+
+if __name__ == '__main__':
+	main()
@@ -0,0 +1,93 @@
+#!/usr/bin/env python3
+"""Packs the status bar icons into a single atlas image.
+
+The icons are placed left to right, top aligned, in the order below. The resulting
+slot rectangles must match STATUS_BAR_ATLAS_SLOT_* in include/window_status_bar.h.
+
+Usage: tools/pack_status_bar_atlas.py   (run from the package root)
+"""
+import struct
+import zlib
+
+IMAGES_DIR = 'src/resources/images/'
+ICONS = [
+	'ICON_STATUS_BAR_PHONE',
+	'ICON_STATUS_BAR_BATTERY',
+	'ICON_STATUS_BAR_CHARGING',
+	'ICON_STATUS_BAR_CHARGING_HALF',
+]
+ATLAS = 'ICON_STATUS_BAR_ATLAS'
+BYTES_PER_PIXEL = 4		# 8-bit RGBA
+
+
+def read_png(path):
+	with open(path, 'rb') as f:
+		data = f.read()
+	assert data[:8] == b'\x89PNG\r\n\x1a\n', path
+	
+	pos, idat = 8, b''
+	while pos < len(data):
+		length, kind = struct.unpack('>I4s', data[pos:pos + 8])
+		body = data[pos + 8:pos + 8 + length]
+		if kind == b'IHDR':
+			width, height, depth, color_type, _, _, interlace = struct.unpack('>IIBBBBB', body)
+			assert (depth, color_type, interlace) == (8, 6, 0), path + ': only 8-bit RGBA, non-interlaced'
+		elif kind == b'IDAT':
+			idat += body
+		pos += 12 + length
+	
+	raw = zlib.decompress(idat)
+	stride = width * BYTES_PER_PIXEL
+	rows, prev = [], bytearray(stride)
+	for y in range(height):
+		start = y * (stride + 1)
+		kind, row = raw[start], bytearray(raw[start + 1:start + 1 + stride])
+		for x in range(stride):
+			a = row[x - BYTES_PER_PIXEL] if x >= BYTES_PER_PIXEL else 0
+			b = prev[x]
+			c = prev[x - BYTES_PER_PIXEL] if x >= BYTES_PER_PIXEL else 0
+			if kind == 1:
+				row[x] = (row[x] + a) & 0xff
+			elif kind == 2:
+				row[x] = (row[x] + b) & 0xff
+			elif kind == 3:
+				row[x] = (row[x] + (a + b) // 2) & 0xff
+			elif kind == 4:
+				p = a + b - c
+				pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+				row[x] = (row[x] + (a if pa <= pb and pa <= pc else b if pb <= pc else c)) & 0xff
+		rows.append(row)
+		prev = row
+	return width, height, rows
+
+
+def write_png(path, width, height, rows):
+	def chunk(kind, body):
+		return struct.pack('>I', len(body)) + kind + body + struct.pack('>I', zlib.crc32(kind + body) & 0xffffffff)
+	
+	raw = b''.join(b'\x00' + bytes(row) for row in rows)
+	with open(path, 'wb') as f:
+		f.write(b'\x89PNG\r\n\x1a\n')
+		f.write(chunk(b'IHDR', struct.pack('>IIBBBBB', width, height, 8, 6, 0, 0, 0)))
+		f.write(chunk(b'IDAT', zlib.compress(raw, 9)))
+		f.write(chunk(b'IEND', b''))
+
+
+def main():
+	icons = [read_png(IMAGES_DIR + name) for name in ICONS]
+	width = sum(icon[0] for icon in icons)
+	height = max(icon[1] for icon in icons)
+	atlas = [bytearray(width * BYTES_PER_PIXEL) for _ in range(height)]
+	
+	x = 0
+	for name, (icon_width, icon_height, rows) in zip(ICONS, icons):
+		for y, row in enumerate(rows):
+			atlas[y][x * BYTES_PER_PIXEL:(x + icon_width) * BYTES_PER_PIXEL] = row
+		print('%s: GRect(%d, 0, %d, %d)' % (name, x, icon_width, icon_height))
+		x += icon_width
+	
+	write_png(IMAGES_DIR + ATLAS, width, height, atlas)
+
+
+if __name__ == '__main__':
+	main()
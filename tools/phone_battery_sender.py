@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+"""Stand-in for the phone side of the phone battery protocol, for testing on the host.
+
+Simulates a phone battery that drains (or charges, with --charging) and sends its state to the
+watch app the way a companion app should:
+
+- the state is a single uint8 under the STATUS_BAR_PHONE_BATTERY message key: the charge in
+  STATUS_BAR_BATTERY_CHARGE_STEP units (0-10) in the low bits, plus 0x80 while charging
+  (see STATUS_BAR_PHONE_BATTERY_* in include/window_status_bar.h)
+- only changes of that byte are sent, so the radio stays off while the charge moves inside a bucket
+- changes are sent at most once per --min-interval seconds (the latest state wins)
+- the watch forgets the charge when the phone disconnects, so the current state is sent again
+  as soon as the connection is back (a lost connection is retried every --tick)
+
+The message key id is assigned when the app is built, look it up in build/js/message_keys.json.
+The emulator's websocket port is the one `pebble` uses for it (see /tmp/pb-emulator.json).
+
+Usage: tools/phone_battery_sender.py --url ws://localhost:PORT --uuid APP_UUID --key KEY [options]
+       tools/phone_battery_sender.py --dry-run [options]   (prints what would be sent, needs no watch)
+"""
+import argparse
+import time
+import uuid
+
+CHARGE_MAX = 100
+CHARGE_STEP = 10		# STATUS_BAR_BATTERY_CHARGE_STEP
+CHARGING_FLAG = 0x80	# STATUS_BAR_PHONE_BATTERY_CHARGING_FLAG
+
+
+def encode(charge_percent, is_charging):
+	level = min(max(int(charge_percent), 0), CHARGE_MAX) // CHARGE_STEP
+	return (CHARGING_FLAG if is_charging else 0) | level
+
+
+def connect(url, app_uuid, key):
+	"""Returns (send, is_connected) for a new connection, or None if the phone/emulator can't be reached."""
+	# only needed when actually sending, so --dry-run works without libpebble2
+	from libpebble2.communication import PebbleConnection
+	from libpebble2.communication.transports.websocket import WebsocketTransport
+	from libpebble2.services.appmessage import AppMessageService, Uint8
+
+	pebble = PebbleConnection(WebsocketTransport(url))
+	try:
+		pebble.connect()
+	except Exception as error:		# whatever the transport raises, there's no connection
+		print('cannot connect to %s: %s' % (url, error))
+		return None
+	pebble.run_async()
+	service = AppMessageService(pebble)
+
+	def send(value):
+		service.send_message(app_uuid, {key: Uint8(value)})
+	return send, lambda: pebble.connected
+
+
+def main():
+	parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+	parser.add_argument('--url', help='websocket of the phone/emulator connection')
+	parser.add_argument('--uuid', type=uuid.UUID, help='UUID of the watch app')
+	parser.add_argument('--key', type=int, help='id of the STATUS_BAR_PHONE_BATTERY message key')
+	parser.add_argument('--dry-run', action='store_true', help='only print what would be sent')
+	parser.add_argument('--start', type=float, default=CHARGE_MAX, help='initial charge, in percent')
+	parser.add_argument('--rate', type=float, default=1.0, help='charge change per second, in percent')
+	parser.add_argument('--charging', action='store_true', help='charge instead of draining')
+	parser.add_argument('--min-interval', type=float, default=60.0, help='minimum seconds between sends')
+	parser.add_argument('--tick', type=float, default=1.0, help='seconds between battery samples')
+	args = parser.parse_args()
+
+	if args.dry_run:
+		open_link = lambda: (lambda value: None, lambda: True)
+	elif None in (args.url, args.uuid, args.key):
+		parser.error('--url, --uuid and --key are needed, unless --dry-run is used')
+	else:
+		open_link = lambda: connect(args.url, args.uuid, args.key)
+
+	charge = args.start
+	link = None
+	last_value, last_send = None, None
+	samples, sends = 0, 0
+	try:
+		while True:
+			value = encode(charge, args.charging)
+			now = time.monotonic()
+			samples += 1
+
+			# a new connection starts with nothing sent, so the current state goes out right away
+			if link is None or not link[1]():
+				link = open_link()
+				last_value, last_send = None, None
+
+			if link is not None and value != last_value and (last_send is None or now - last_send >= args.min_interval):
+				try:
+					link[0](value)
+				except Exception as error:		# whatever the transport raises, the connection is gone
+					print('send failed: %s' % error)
+					link = None
+				else:
+					last_value, last_send = value, now
+					sends += 1
+					print('%5.1f%% %-8s -> 0x%02x   (%d sends, %d samples)' % (
+						charge, 'charging' if args.charging else '', value, sends, samples))
+
+			if args.charging:
+				charge = min(charge + args.rate * args.tick, CHARGE_MAX)
+			else:
+				charge = max(charge - args.rate * args.tick, 0)
+			time.sleep(args.tick)
+	except KeyboardInterrupt:
+		pass
+
+
+if __name__ == '__main__':
+	main()